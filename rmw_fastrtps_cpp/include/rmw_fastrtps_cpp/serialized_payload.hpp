@@ -0,0 +1,84 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_CPP__SERIALIZED_PAYLOAD_HPP_
+#define RMW_FASTRTPS_CPP__SERIALIZED_PAYLOAD_HPP_
+
+#include <cstddef>
+
+#include "rmw/rmw.h"
+#include "rmw_fastrtps_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_cpp
+{
+
+/// Borrow a buffer from the DataWriter of a publisher, to write a serialized message into.
+/**
+ * The CDR serialized message, including its encapsulation header, is written into the
+ * `buffer` of `serialized_message`, and its length stored in `buffer_length`.
+ * Publishing it with publish_borrowed_serialized_payload() does not copy it, as the buffer
+ * already belongs to the payload pool of the DataWriter.
+ *
+ * The buffer cannot be resized, so its allocator is zero initialized.
+ * It must be given back, either by publishing it or with return_borrowed_serialized_payload().
+ *
+ * Only publishers of the topics listed in the environment variable
+ * RMW_FASTRTPS_BORROWED_PAYLOAD_TOPICS lend buffers, as their DataWriters then allocate the
+ * buffers of their samples on demand instead of preallocating them.
+ *
+ * \param[in] publisher Publisher to borrow the buffer from.
+ * \param[in] size Minimum capacity of the buffer, in bytes.
+ * \param[out] serialized_message Zero initialized serialized message, receiving the buffer.
+ * \return `RMW_RET_OK` if successful, or
+ * \return `RMW_RET_INVALID_ARGUMENT` if an argument is invalid, or
+ * \return `RMW_RET_INCORRECT_RMW_IMPLEMENTATION` if the publisher is from a different
+ *   rmw implementation, or
+ * \return `RMW_RET_UNSUPPORTED` if the publisher does not lend buffers or uses data-sharing, or
+ * \return `RMW_RET_BAD_ALLOC` if the buffer cannot be allocated.
+ */
+RMW_FASTRTPS_CPP_PUBLIC
+rmw_ret_t
+borrow_serialized_payload(
+  const rmw_publisher_t * publisher,
+  size_t size,
+  rmw_serialized_message_t * serialized_message);
+
+/// Give back a borrowed buffer without publishing it.
+/**
+ * \return `RMW_RET_OK` if successful, or
+ * \return `RMW_RET_ERROR` if the buffer was not borrowed from this publisher.
+ */
+RMW_FASTRTPS_CPP_PUBLIC
+rmw_ret_t
+return_borrowed_serialized_payload(
+  const rmw_publisher_t * publisher,
+  rmw_serialized_message_t * serialized_message);
+
+/// Publish a serialized message written into a borrowed buffer, without copying it.
+/**
+ * The buffer is given back whatever the result, and `serialized_message` is zero initialized.
+ *
+ * \return `RMW_RET_OK` if successful, or
+ * \return `RMW_RET_ERROR` if the buffer was not borrowed from this publisher or could not be
+ *   published.
+ */
+RMW_FASTRTPS_CPP_PUBLIC
+rmw_ret_t
+publish_borrowed_serialized_payload(
+  const rmw_publisher_t * publisher,
+  rmw_serialized_message_t * serialized_message);
+
+}  // namespace rmw_fastrtps_cpp
+
+#endif  // RMW_FASTRTPS_CPP__SERIALIZED_PAYLOAD_HPP_
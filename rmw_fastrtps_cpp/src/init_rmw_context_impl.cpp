@@ -16,6 +16,9 @@
 
 #include <cassert>
 #include <memory>
+#include <new>
+
+#include "fastdds/dds/topic/TypeSupport.hpp"
 
 #include "rmw/error_handling.h"
 #include "rmw/init.h"
@@ -29,6 +32,7 @@
 #include "rmw_fastrtps_cpp/subscription.hpp"
 
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
+#include "rmw_fastrtps_shared_cpp/discovery_info.hpp"
 #include "rmw_fastrtps_shared_cpp/participant.hpp"
 #include "rmw_fastrtps_shared_cpp/publisher.hpp"
 #include "rmw_fastrtps_shared_cpp/subscription.hpp"
@@ -38,8 +42,40 @@
 
 #include "rmw_fastrtps_shared_cpp/listener_thread.hpp"
 
+#include "./type_support_common.hpp"
+
 using rmw_dds_common::msg::ParticipantEntitiesInfo;
 
+// Register ParticipantEntitiesInfo keyed on the participant gid, so that the endpoints of
+// ros_discovery_info, which reuse the type registered in the participant, are keyed.
+static
+bool
+register_keyed_discovery_info_type(CustomParticipantInfo * participant_info)
+{
+  const rosidl_message_type_support_t * type_support = get_message_typesupport_handle(
+    rosidl_typesupport_cpp::get_message_type_support_handle<ParticipantEntitiesInfo>(),
+    RMW_FASTRTPS_CPP_TYPESUPPORT_CPP);
+  if (!type_support) {
+    return false;
+  }
+
+  auto callbacks = static_cast<const message_type_support_callbacks_t *>(type_support->data);
+  auto tsupport = new (std::nothrow) MessageTypeSupport_cpp(callbacks);
+  if (!tsupport) {
+    RMW_SET_ERROR_MSG("failed to allocate MessageTypeSupport");
+    return false;
+  }
+  tsupport->set_key_size(rmw_fastrtps_shared_cpp::discovery_info_key_size);
+
+  // Transfer ownership to fastdds_type
+  eprosima::fastdds::dds::TypeSupport fastdds_type(tsupport);
+  if (ReturnCode_t::RETCODE_OK != fastdds_type.register_type(participant_info->participant_)) {
+    RMW_SET_ERROR_MSG("failed to register keyed discovery info type");
+    return false;
+  }
+  return true;
+}
+
 static
 rmw_ret_t
 init_context_impl(
@@ -78,6 +114,13 @@ init_context_impl(
     return RMW_RET_BAD_ALLOC;
   }
 
+  // Keyed and unkeyed topics never match, so ros_discovery_info is only keyed on demand, not to
+  // stop exchanging the graph with implementations keeping it unkeyed
+  const bool keyed = participant_info->keyed_discovery_info;
+  if (keyed && !register_keyed_discovery_info_type(participant_info.get())) {
+    return RMW_RET_ERROR;
+  }
+
   rmw_qos_profile_t qos = rmw_qos_profile_default;
 
   qos.avoid_ros_namespace_conventions = true;
@@ -110,8 +153,10 @@ init_context_impl(
     return RMW_RET_BAD_ALLOC;
   }
 
-  // If we would have support for keyed topics, this could be KEEP_LAST and depth 1.
-  qos.history = RMW_QOS_POLICY_HISTORY_KEEP_ALL;
+  // When keyed on the gid of the participant, only the last update of each participant is kept.
+  if (!keyed) {
+    qos.history = RMW_QOS_POLICY_HISTORY_KEEP_ALL;
+  }
   std::unique_ptr<rmw_subscription_t, std::function<void(rmw_subscription_t *)>>
   subscription(
     rmw_fastrtps_cpp::create_subscription(
@@ -120,7 +165,7 @@ init_context_impl(
       "ros_discovery_info",
       &qos,
       &subscription_options,
-      false),       // our fastrtps typesupport doesn't support keyed topics
+      keyed),
     [&](rmw_subscription_t * sub)
     {
       if (RMW_RET_OK != rmw_fastrtps_shared_cpp::destroy_subscription(
@@ -161,18 +206,40 @@ init_context_impl(
 
   context->impl->common = common_context.get();
   context->impl->participant_info = participant_info.get();
+  context->impl->graph_update_publisher.reset(
+    new (std::nothrow) rmw_fastrtps_shared_cpp::GraphUpdatePublisher(
+      eprosima_fastrtps_identifier, common_context.get()));
+  if (!context->impl->graph_update_publisher) {
+    return RMW_RET_BAD_ALLOC;
+  }
+  context->impl->graph_change_notifier = rmw_fastrtps_shared_cpp::GraphChangeNotifier::create(
+    eprosima_fastrtps_identifier, common_context.get());
+  if (!context->impl->graph_change_notifier) {
+    context->impl->graph_update_publisher.reset();
+    return RMW_RET_ERROR;
+  }
+  context->impl->response_flusher.reset(
+    new (std::nothrow) rmw_fastrtps_shared_cpp::ResponseFlusher(
+      eprosima_fastrtps_identifier, common_context.get()));
+  if (!context->impl->response_flusher) {
+    context->impl->graph_change_notifier.reset();
+    context->impl->graph_update_publisher.reset();
+    return RMW_RET_BAD_ALLOC;
+  }
 
   rmw_ret_t ret = rmw_fastrtps_shared_cpp::run_listener_thread(context);
   if (RMW_RET_OK != ret) {
+    context->impl->response_flusher.reset();
+    context->impl->graph_change_notifier.reset();
+    context->impl->graph_update_publisher.reset();
     return ret;
   }
 
   common_context->graph_cache.set_on_change_callback(
-    [guard_condition = graph_guard_condition.get()]()
+    [impl = context->impl]()
     {
-      rmw_fastrtps_shared_cpp::__rmw_trigger_guard_condition(
-        eprosima_fastrtps_identifier,
-        guard_condition);
+      impl->names_and_types_cache.invalidate();
+      impl->graph_change_notifier->notify();
     });
 
   common_context->graph_cache.add_participant(
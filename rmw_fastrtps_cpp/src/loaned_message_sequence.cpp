@@ -0,0 +1,46 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "rmw_fastrtps_cpp/loaned_message_sequence.hpp"
+
+#include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+#include "rmw_fastrtps_cpp/identifier.hpp"
+
+namespace rmw_fastrtps_cpp
+{
+
+rmw_ret_t
+take_loaned_message_sequence(
+  const rmw_subscription_t * subscription,
+  size_t count,
+  rmw_message_sequence_t * message_sequence,
+  rmw_message_info_sequence_t * message_info_sequence,
+  size_t * taken)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_take_loaned_message_sequence(
+    eprosima_fastrtps_identifier, subscription, count, message_sequence, message_info_sequence,
+    taken);
+}
+
+rmw_ret_t
+return_loaned_message_sequence(
+  const rmw_subscription_t * subscription,
+  rmw_message_sequence_t * message_sequence)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_return_loaned_message_sequence(
+    eprosima_fastrtps_identifier, subscription, message_sequence);
+}
+
+}  // namespace rmw_fastrtps_cpp
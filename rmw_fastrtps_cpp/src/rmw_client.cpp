@@ -194,6 +194,10 @@ rmw_create_client(
 
   auto cleanup_info = rcpputils::make_scope_exit(
     [info, participant_info]() {
+      if (info->response_filtered_topic_) {
+        participant_info->participant_->delete_contentfilteredtopic(
+          info->response_filtered_topic_);
+      }
       rmw_fastrtps_shared_cpp::remove_topic_and_type(
         participant_info, nullptr, info->response_topic_, info->response_type_support_);
       rmw_fastrtps_shared_cpp::remove_topic_and_type(
@@ -274,7 +278,15 @@ rmw_create_client(
     return nullptr;
   }
 
-  response_topic_desc = info->response_topic_;
+  // Only receive the responses to the requests of this client
+  if (!rmw_fastrtps_shared_cpp::create_response_filtered_topic(
+      dds_participant, info->response_topic_, &info->response_filtered_topic_))
+  {
+    RMW_SET_ERROR_MSG("create_client() failed to create response contentfilteredtopic");
+    return nullptr;
+  }
+
+  response_topic_desc = info->response_filtered_topic_;
 
   // Create request topic
   info->request_topic_ = participant_info->find_or_create_topic(
@@ -328,7 +340,8 @@ rmw_create_client(
     response_topic_desc,
     reader_qos,
     info->listener_,
-    eprosima::fastdds::dds::StatusMask::subscription_matched());
+    eprosima::fastdds::dds::StatusMask::subscription_matched() <<
+    eprosima::fastdds::dds::StatusMask::data_available());
 
   if (!info->response_reader_) {
     RMW_SET_ERROR_MSG("create_client() failed to create response DataReader");
@@ -461,11 +474,7 @@ rmw_create_client(
       common_context->gid,
       node->name,
       node->namespace_);
-    rmw_ret_t ret = rmw_fastrtps_shared_cpp::__rmw_publish(
-      eprosima_fastrtps_identifier,
-      common_context->pub,
-      static_cast<void *>(&msg),
-      nullptr);
+    rmw_ret_t ret = node->context->impl->graph_update_publisher->publish(msg);
     if (RMW_RET_OK != ret) {
       common_context->graph_cache.dissociate_reader(
         response_subscriber_gid,
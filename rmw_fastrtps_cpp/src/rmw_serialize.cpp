@@ -12,6 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 #include "fastcdr/FastBuffer.h"
 
 #include "rmw/error_handling.h"
@@ -20,13 +24,28 @@
 
 #include "./type_support_common.hpp"
 
-extern "C"
+namespace
 {
-rmw_ret_t
-rmw_serialize(
-  const void * ros_message,
-  const rosidl_message_type_support_t * type_support,
-  rmw_serialized_message_t * serialized_message)
+
+// MessageTypeSupport objects are created once per type, on the first (de)serialization.
+// Type support callbacks are static data of the library defining the type, so they are kept.
+const MessageTypeSupport_cpp *
+get_message_type_support(const message_type_support_callbacks_t * callbacks)
+{
+  static std::mutex mutex;
+  static std::unordered_map<
+    const message_type_support_callbacks_t *, std::unique_ptr<MessageTypeSupport_cpp>> types;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  std::unique_ptr<MessageTypeSupport_cpp> & tss = types[callbacks];
+  if (!tss) {
+    tss = std::make_unique<MessageTypeSupport_cpp>(callbacks);
+  }
+  return tss.get();
+}
+
+const rosidl_message_type_support_t *
+get_fastrtps_type_support(const rosidl_message_type_support_t * type_support)
 {
   const rosidl_message_type_support_t * ts = get_message_typesupport_handle(
     type_support, RMW_FASTRTPS_CPP_TYPESUPPORT_C);
@@ -35,13 +54,29 @@ rmw_serialize(
       type_support, RMW_FASTRTPS_CPP_TYPESUPPORT_CPP);
     if (!ts) {
       RMW_SET_ERROR_MSG("type support not from this implementation");
-      return RMW_RET_ERROR;
     }
   }
+  return ts;
+}
+
+}  // namespace
+
+extern "C"
+{
+rmw_ret_t
+rmw_serialize(
+  const void * ros_message,
+  const rosidl_message_type_support_t * type_support,
+  rmw_serialized_message_t * serialized_message)
+{
+  const rosidl_message_type_support_t * ts = get_fastrtps_type_support(type_support);
+  if (!ts) {
+    return RMW_RET_ERROR;
+  }
 
   auto callbacks = static_cast<const message_type_support_callbacks_t *>(ts->data);
-  auto tss = MessageTypeSupport_cpp(callbacks);
-  auto data_length = tss.getEstimatedSerializedSize(ros_message, callbacks);
+  auto tss = get_message_type_support(callbacks);
+  auto data_length = tss->getEstimatedSerializedSize(ros_message, callbacks);
   if (serialized_message->buffer_capacity < data_length) {
     if (rmw_serialized_message_resize(serialized_message, data_length) != RMW_RET_OK) {
       RMW_SET_ERROR_MSG("unable to dynamically resize serialized message");
@@ -54,9 +89,8 @@ rmw_serialize(
   eprosima::fastcdr::Cdr ser(
     buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN, eprosima::fastcdr::Cdr::DDS_CDR);
 
-  auto ret = tss.serializeROSmessage(ros_message, ser, callbacks);
+  auto ret = tss->serializeROSmessage(ros_message, ser, callbacks);
   serialized_message->buffer_length = data_length;
-  serialized_message->buffer_capacity = data_length;
   return ret == true ? RMW_RET_OK : RMW_RET_ERROR;
 }
 
@@ -66,35 +100,47 @@ rmw_deserialize(
   const rosidl_message_type_support_t * type_support,
   void * ros_message)
 {
-  const rosidl_message_type_support_t * ts = get_message_typesupport_handle(
-    type_support, RMW_FASTRTPS_CPP_TYPESUPPORT_C);
+  const rosidl_message_type_support_t * ts = get_fastrtps_type_support(type_support);
   if (!ts) {
-    ts = get_message_typesupport_handle(
-      type_support, RMW_FASTRTPS_CPP_TYPESUPPORT_CPP);
-    if (!ts) {
-      RMW_SET_ERROR_MSG("type support not from this implementation");
-      return RMW_RET_ERROR;
-    }
+    return RMW_RET_ERROR;
   }
 
   auto callbacks = static_cast<const message_type_support_callbacks_t *>(ts->data);
-  auto tss = MessageTypeSupport_cpp(callbacks);
+  auto tss = get_message_type_support(callbacks);
   eprosima::fastcdr::FastBuffer buffer(
     reinterpret_cast<char *>(serialized_message->buffer), serialized_message->buffer_length);
   eprosima::fastcdr::Cdr deser(buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN,
     eprosima::fastcdr::Cdr::DDS_CDR);
 
-  auto ret = tss.deserializeROSmessage(deser, ros_message, callbacks);
+  auto ret = tss->deserializeROSmessage(deser, ros_message, callbacks);
   return ret == true ? RMW_RET_OK : RMW_RET_ERROR;
 }
 
 rmw_ret_t
 rmw_get_serialized_message_size(
-  const rosidl_message_type_support_t * /*type_support*/,
-  const rosidl_runtime_c__Sequence__bound * /*message_bounds*/,
-  size_t * /*size*/)
+  const rosidl_message_type_support_t * type_support,
+  const rosidl_runtime_c__Sequence__bound * message_bounds,
+  size_t * size)
 {
-  RMW_SET_ERROR_MSG("unimplemented");
-  return RMW_RET_UNSUPPORTED;
+  RMW_CHECK_ARGUMENT_FOR_NULL(type_support, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(size, RMW_RET_INVALID_ARGUMENT);
+  // Type supports do not provide the size of the elements of a sequence bound
+  (void)message_bounds;
+
+  const rosidl_message_type_support_t * ts = get_fastrtps_type_support(type_support);
+  if (!ts) {
+    return RMW_RET_ERROR;
+  }
+
+  auto callbacks = static_cast<const message_type_support_callbacks_t *>(ts->data);
+  auto tss = get_message_type_support(callbacks);
+  if (!tss->is_bounded()) {
+    RMW_SET_ERROR_MSG("serialized size of unbounded message types is not supported");
+    return RMW_RET_UNSUPPORTED;
+  }
+
+  // Same size used for the samples of the type, including the encapsulation
+  *size = tss->m_typeSize;
+  return RMW_RET_OK;
 }
 }  // extern "C"
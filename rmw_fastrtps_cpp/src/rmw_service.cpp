@@ -253,7 +253,8 @@ rmw_create_service(
     return nullptr;
   }
 
-  info->pub_listener_ = new (std::nothrow) ServicePubListener(info);
+  info->pub_listener_ = new (std::nothrow) ServicePubListener(
+    info, node->context->impl->response_flusher.get());
   if (!info->pub_listener_) {
     RMW_SET_ERROR_MSG("create_service() failed to create response publisher listener");
     return nullptr;
@@ -327,7 +328,8 @@ rmw_create_service(
     request_topic_desc,
     reader_qos,
     info->listener_,
-    eprosima::fastdds::dds::StatusMask::subscription_matched());
+    eprosima::fastdds::dds::StatusMask::subscription_matched() <<
+    eprosima::fastdds::dds::StatusMask::data_available());
 
   if (!info->request_reader_) {
     RMW_SET_ERROR_MSG("create_service() failed to create request DataReader");
@@ -373,6 +375,10 @@ rmw_create_service(
       eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
 
     writer_qos.data_sharing().off();
+
+    // Filter the responses for every client on this side, instead of only for the first ones
+    writer_qos.writer_resource_limits().reader_filters_allocation =
+      eprosima::fastrtps::ResourceLimitedContainerConfig::dynamic_allocation_configuration();
   }
 
   if (!get_datawriter_qos(
@@ -460,11 +466,7 @@ rmw_create_service(
       common_context->gid,
       node->name,
       node->namespace_);
-    rmw_ret_t ret = rmw_fastrtps_shared_cpp::__rmw_publish(
-      eprosima_fastrtps_identifier,
-      common_context->pub,
-      static_cast<void *>(&msg),
-      nullptr);
+    rmw_ret_t ret = node->context->impl->graph_update_publisher->publish(msg);
     if (RMW_RET_OK != ret) {
       common_context->graph_cache.dissociate_writer(
         response_publisher_gid,
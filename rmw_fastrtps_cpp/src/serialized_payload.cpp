@@ -0,0 +1,51 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rmw_fastrtps_cpp/serialized_payload.hpp"
+
+#include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+#include "rmw_fastrtps_cpp/identifier.hpp"
+
+namespace rmw_fastrtps_cpp
+{
+
+rmw_ret_t
+borrow_serialized_payload(
+  const rmw_publisher_t * publisher,
+  size_t size,
+  rmw_serialized_message_t * serialized_message)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_borrow_serialized_payload(
+    eprosima_fastrtps_identifier, publisher, size, serialized_message);
+}
+
+rmw_ret_t
+return_borrowed_serialized_payload(
+  const rmw_publisher_t * publisher,
+  rmw_serialized_message_t * serialized_message)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_return_borrowed_serialized_payload(
+    eprosima_fastrtps_identifier, publisher, serialized_message);
+}
+
+rmw_ret_t
+publish_borrowed_serialized_payload(
+  const rmw_publisher_t * publisher,
+  rmw_serialized_message_t * serialized_message)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_publish_borrowed_serialized_payload(
+    eprosima_fastrtps_identifier, publisher, serialized_message, nullptr);
+}
+
+}  // namespace rmw_fastrtps_cpp
@@ -381,7 +381,13 @@ __create_dynamic_subscription(
     reader_qos.endpoint().history_memory_policy =
       eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
 
-    reader_qos.data_sharing().off();
+    if (rmw_fastrtps_shared_cpp::use_data_sharing(
+        participant_info, topic_name, info->type_support_))
+    {
+      reader_qos.data_sharing().automatic();
+    } else {
+      reader_qos.data_sharing().off();
+    }
   }
 
   if (!get_datareader_qos(
@@ -392,6 +398,12 @@ __create_dynamic_subscription(
     return nullptr;
   }
 
+  if (info->type_support_->m_isGetKeyDefined) {
+    // Keep the history of every instance, however many there are
+    reader_qos.resource_limits().max_instances = 0;
+    reader_qos.resource_limits().max_samples = 0;
+  }
+
   info->datareader_qos_ = reader_qos;
 
   // create_datareader
@@ -648,7 +660,13 @@ __create_subscription(
     reader_qos.endpoint().history_memory_policy =
       eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
 
-    reader_qos.data_sharing().off();
+    if (rmw_fastrtps_shared_cpp::use_data_sharing(
+        participant_info, topic_name, info->type_support_))
+    {
+      reader_qos.data_sharing().automatic();
+    } else {
+      reader_qos.data_sharing().off();
+    }
   }
 
   if (!get_datareader_qos(
@@ -659,6 +677,12 @@ __create_subscription(
     return nullptr;
   }
 
+  if (info->type_support_->m_isGetKeyDefined) {
+    // Keep the history of every instance, however many there are
+    reader_qos.resource_limits().max_instances = 0;
+    reader_qos.resource_limits().max_samples = 0;
+  }
+
   info->datareader_qos_ = reader_qos;
 
   // create_datareader
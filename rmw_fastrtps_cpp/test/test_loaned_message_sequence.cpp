@@ -0,0 +1,222 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "osrf_testing_tools_cpp/scope_exit.hpp"
+
+#include "rcutils/allocator.h"
+#include "rcutils/strdup.h"
+
+#include "rmw/error_handling.h"
+#include "rmw/rmw.h"
+
+#include "rmw_fastrtps_cpp/get_subscriber.hpp"
+#include "rmw_fastrtps_cpp/loaned_message_sequence.hpp"
+
+#include "test_msgs/msg/builtins.h"
+
+class TestLoanedMessageSequence : public ::testing::Test
+{
+protected:
+  static constexpr size_t published_count = 10u;
+
+  void SetUp() override
+  {
+    rmw_init_options_t options = rmw_get_zero_initialized_init_options();
+    rmw_ret_t ret = rmw_init_options_init(&options, rcutils_get_default_allocator());
+    ASSERT_EQ(RMW_RET_OK, ret) << rcutils_get_error_string().str;
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      rmw_ret_t ret = rmw_init_options_fini(&options);
+      EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    });
+    options.enclave = rcutils_strdup("/", rcutils_get_default_allocator());
+    ASSERT_STREQ("/", options.enclave);
+    options.discovery_options.automatic_discovery_range = RMW_AUTOMATIC_DISCOVERY_RANGE_OFF;
+    ret = rmw_init(&options, &context);
+    ASSERT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    node = rmw_create_node(&context, "my_node", "/my_ns");
+    ASSERT_NE(nullptr, node) << rmw_get_error_string().str;
+
+    // A plain message type, so the subscription can loan its messages
+    const rosidl_message_type_support_t * ts =
+      ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Builtins);
+    rmw_qos_profile_t qos_profile = rmw_qos_profile_default;
+    qos_profile.depth = published_count;
+    rmw_publisher_options_t pub_options = rmw_get_default_publisher_options();
+    pub = rmw_create_publisher(node, ts, "/test", &qos_profile, &pub_options);
+    ASSERT_NE(nullptr, pub) << rmw_get_error_string().str;
+    rmw_subscription_options_t sub_options = rmw_get_default_subscription_options();
+    sub = rmw_create_subscription(node, ts, "/test", &qos_profile, &sub_options);
+    ASSERT_NE(nullptr, sub) << rmw_get_error_string().str;
+    ASSERT_TRUE(sub->can_loan_messages);
+
+    rcutils_allocator_t allocator = rcutils_get_default_allocator();
+    ret = rmw_message_sequence_init(&sequence, published_count, &allocator);
+    ASSERT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_message_info_sequence_init(&info_sequence, published_count, &allocator);
+    ASSERT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+  }
+
+  void TearDown() override
+  {
+    rmw_ret_t ret = rmw_message_info_sequence_fini(&info_sequence);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_message_sequence_fini(&sequence);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    if (sub) {
+      ret = rmw_destroy_subscription(node, sub);
+      EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    }
+    if (pub) {
+      ret = rmw_destroy_publisher(node, pub);
+      EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    }
+    ret = rmw_destroy_node(node);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_shutdown(&context);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_context_fini(&context);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+  }
+
+  // Publish count messages, numbered from first, and wait for all of them to be received
+  void publish(size_t count, size_t first)
+  {
+    size_t matched = 0u;
+    for (int ii = 0; ii < 100 && 0u == matched; ++ii) {
+      ASSERT_EQ(RMW_RET_OK, rmw_subscription_count_matched_publishers(sub, &matched));
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    ASSERT_EQ(1u, matched);
+
+    test_msgs__msg__Builtins msg;
+    ASSERT_TRUE(test_msgs__msg__Builtins__init(&msg));
+    for (size_t ii = 0u; ii < count; ++ii) {
+      msg.time_value.sec = static_cast<int32_t>(first + ii);
+      ASSERT_EQ(RMW_RET_OK, rmw_publish(pub, &msg, nullptr)) << rmw_get_error_string().str;
+    }
+    test_msgs__msg__Builtins__fini(&msg);
+
+    auto reader = rmw_fastrtps_cpp::get_datareader(sub);
+    ASSERT_NE(nullptr, reader);
+    for (int ii = 0; ii < 100 && reader->get_unread_count() < count; ++ii) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    ASSERT_EQ(count, reader->get_unread_count());
+  }
+
+  void check_loaned(size_t taken, size_t first)
+  {
+    ASSERT_EQ(taken, sequence.size);
+    ASSERT_EQ(taken, info_sequence.size);
+    for (size_t ii = 0u; ii < taken; ++ii) {
+      auto message = static_cast<const test_msgs__msg__Builtins *>(sequence.data[ii]);
+      ASSERT_NE(nullptr, message);
+      EXPECT_EQ(static_cast<int32_t>(first + ii), message->time_value.sec);
+    }
+  }
+
+  rmw_context_t context{rmw_get_zero_initialized_context()};
+  rmw_node_t * node{nullptr};
+  rmw_publisher_t * pub{nullptr};
+  rmw_subscription_t * sub{nullptr};
+  rmw_message_sequence_t sequence{rmw_get_zero_initialized_message_sequence()};
+  rmw_message_info_sequence_t info_sequence{rmw_get_zero_initialized_message_info_sequence()};
+};
+
+TEST_F(TestLoanedMessageSequence, loan_burst_with_one_take) {
+  publish(published_count, 0u);
+
+  size_t taken = 0u;
+  rmw_ret_t ret = rmw_fastrtps_cpp::take_loaned_message_sequence(
+    sub, published_count, &sequence, &info_sequence, &taken);
+  ASSERT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+  ASSERT_EQ(published_count, taken);
+  check_loaned(taken, 0u);
+
+  // The whole burst is given back at once
+  ret = rmw_fastrtps_cpp::return_loaned_message_sequence(sub, &sequence);
+  EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+  EXPECT_EQ(0u, sequence.size);
+
+  // Nothing is left to give back
+  ret = rmw_fastrtps_cpp::return_loaned_message_sequence(sub, &sequence);
+  EXPECT_EQ(RMW_RET_INVALID_ARGUMENT, ret);
+  rmw_reset_error();
+
+  // Nothing is left to take
+  ret = rmw_fastrtps_cpp::take_loaned_message_sequence(
+    sub, published_count, &sequence, &info_sequence, &taken);
+  EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+  EXPECT_EQ(0u, taken);
+  EXPECT_EQ(0u, sequence.size);
+}
+
+TEST_F(TestLoanedMessageSequence, loan_bursts_while_others_are_loaned) {
+  publish(published_count, 0u);
+
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rmw_message_sequence_t second = rmw_get_zero_initialized_message_sequence();
+  ASSERT_EQ(RMW_RET_OK, rmw_message_sequence_init(&second, published_count, &allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RMW_RET_OK, rmw_message_sequence_fini(&second));
+  });
+
+  // Two bursts, loaned at the same time
+  const size_t first_count = 4u;
+  size_t taken = 0u;
+  rmw_ret_t ret = rmw_fastrtps_cpp::take_loaned_message_sequence(
+    sub, first_count, &sequence, &info_sequence, &taken);
+  ASSERT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+  ASSERT_EQ(first_count, taken);
+  check_loaned(taken, 0u);
+
+  size_t second_taken = 0u;
+  ret = rmw_fastrtps_cpp::take_loaned_message_sequence(
+    sub, published_count, &second, nullptr, &second_taken);
+  ASSERT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+  ASSERT_EQ(published_count - first_count, second_taken);
+  ASSERT_EQ(second_taken, second.size);
+  for (size_t ii = 0u; ii < second_taken; ++ii) {
+    auto message = static_cast<const test_msgs__msg__Builtins *>(second.data[ii]);
+    EXPECT_EQ(static_cast<int32_t>(first_count + ii), message->time_value.sec);
+  }
+
+  // Giving back one burst leaves the other one loaned and readable
+  ret = rmw_fastrtps_cpp::return_loaned_message_sequence(sub, &sequence);
+  EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+  auto last = static_cast<const test_msgs__msg__Builtins *>(second.data[second_taken - 1u]);
+  EXPECT_EQ(static_cast<int32_t>(published_count - 1u), last->time_value.sec);
+  ret = rmw_fastrtps_cpp::return_loaned_message_sequence(sub, &second);
+  EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+  EXPECT_EQ(0u, second.size);
+
+  // The loans have been given back, so new samples can be loaned again
+  publish(published_count, published_count);
+  ret = rmw_fastrtps_cpp::take_loaned_message_sequence(
+    sub, published_count, &sequence, &info_sequence, &taken);
+  ASSERT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+  ASSERT_EQ(published_count, taken);
+  check_loaned(taken, published_count);
+  ret = rmw_fastrtps_cpp::return_loaned_message_sequence(sub, &sequence);
+  EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+}
@@ -0,0 +1,184 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "osrf_testing_tools_cpp/scope_exit.hpp"
+
+#include "rcutils/allocator.h"
+#include "rcutils/strdup.h"
+
+#include "rmw/error_handling.h"
+#include "rmw/rmw.h"
+
+#include "rmw_fastrtps_cpp/get_subscriber.hpp"
+
+#include "test_msgs/msg/basic_types.h"
+
+class TestTakeSequence : public ::testing::Test
+{
+protected:
+  // More than a batch of _take_sequence
+  static constexpr size_t published_count = 40u;
+
+  void SetUp() override
+  {
+    rmw_init_options_t options = rmw_get_zero_initialized_init_options();
+    rmw_ret_t ret = rmw_init_options_init(&options, rcutils_get_default_allocator());
+    ASSERT_EQ(RMW_RET_OK, ret) << rcutils_get_error_string().str;
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      rmw_ret_t ret = rmw_init_options_fini(&options);
+      EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    });
+    options.enclave = rcutils_strdup("/", rcutils_get_default_allocator());
+    ASSERT_STREQ("/", options.enclave);
+    options.discovery_options.automatic_discovery_range = RMW_AUTOMATIC_DISCOVERY_RANGE_OFF;
+    ret = rmw_init(&options, &context);
+    ASSERT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    node = rmw_create_node(&context, "my_node", "/my_ns");
+    ASSERT_NE(nullptr, node) << rmw_get_error_string().str;
+
+    const rosidl_message_type_support_t * ts =
+      ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, BasicTypes);
+    rmw_qos_profile_t qos_profile = rmw_qos_profile_default;
+    qos_profile.depth = published_count;
+    rmw_publisher_options_t pub_options = rmw_get_default_publisher_options();
+    pub = rmw_create_publisher(node, ts, "/test", &qos_profile, &pub_options);
+    ASSERT_NE(nullptr, pub) << rmw_get_error_string().str;
+    rmw_subscription_options_t sub_options = rmw_get_default_subscription_options();
+    sub = rmw_create_subscription(node, ts, "/test", &qos_profile, &sub_options);
+    ASSERT_NE(nullptr, sub) << rmw_get_error_string().str;
+  }
+
+  void TearDown() override
+  {
+    rmw_ret_t ret = RMW_RET_OK;
+    if (sub) {
+      ret = rmw_destroy_subscription(node, sub);
+      EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    }
+    if (pub) {
+      ret = rmw_destroy_publisher(node, pub);
+      EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    }
+    ret = rmw_destroy_node(node);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_shutdown(&context);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_context_fini(&context);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+  }
+
+  // Publish published_count messages, numbered from 0, and wait for all of them to be received
+  void publish_all()
+  {
+    size_t matched = 0u;
+    for (int ii = 0; ii < 100 && 0u == matched; ++ii) {
+      ASSERT_EQ(RMW_RET_OK, rmw_subscription_count_matched_publishers(sub, &matched));
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    ASSERT_EQ(1u, matched);
+
+    test_msgs__msg__BasicTypes msg;
+    ASSERT_TRUE(test_msgs__msg__BasicTypes__init(&msg));
+    for (size_t ii = 0u; ii < published_count; ++ii) {
+      msg.int32_value = static_cast<int32_t>(ii);
+      ASSERT_EQ(RMW_RET_OK, rmw_publish(pub, &msg, nullptr)) << rmw_get_error_string().str;
+    }
+    test_msgs__msg__BasicTypes__fini(&msg);
+
+    auto reader = rmw_fastrtps_cpp::get_datareader(sub);
+    ASSERT_NE(nullptr, reader);
+    for (int ii = 0; ii < 100 && reader->get_unread_count() < published_count; ++ii) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    ASSERT_EQ(published_count, reader->get_unread_count());
+  }
+
+  // Take up to count messages, checking they carry the numbers from first on
+  void take_and_check(size_t count, size_t first, size_t expected)
+  {
+    std::vector<test_msgs__msg__BasicTypes> messages(count);
+    for (auto & message : messages) {
+      ASSERT_TRUE(test_msgs__msg__BasicTypes__init(&message));
+    }
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      for (auto & message : messages) {
+        test_msgs__msg__BasicTypes__fini(&message);
+      }
+    });
+
+    rcutils_allocator_t allocator = rcutils_get_default_allocator();
+    rmw_message_sequence_t sequence = rmw_get_zero_initialized_message_sequence();
+    ASSERT_EQ(RMW_RET_OK, rmw_message_sequence_init(&sequence, count, &allocator));
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      EXPECT_EQ(RMW_RET_OK, rmw_message_sequence_fini(&sequence));
+    });
+    for (size_t ii = 0u; ii < count; ++ii) {
+      sequence.data[ii] = &messages[ii];
+    }
+    rmw_message_info_sequence_t info_sequence = rmw_get_zero_initialized_message_info_sequence();
+    ASSERT_EQ(RMW_RET_OK, rmw_message_info_sequence_init(&info_sequence, count, &allocator));
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      EXPECT_EQ(RMW_RET_OK, rmw_message_info_sequence_fini(&info_sequence));
+    });
+
+    size_t taken = 0u;
+    ASSERT_EQ(
+      RMW_RET_OK,
+      rmw_take_sequence(sub, count, &sequence, &info_sequence, &taken, nullptr)) <<
+      rmw_get_error_string().str;
+    ASSERT_EQ(expected, taken);
+    EXPECT_EQ(expected, sequence.size);
+    EXPECT_EQ(expected, info_sequence.size);
+    for (size_t ii = 0u; ii < taken; ++ii) {
+      EXPECT_EQ(static_cast<int32_t>(first + ii), messages[ii].int32_value);
+    }
+  }
+
+  rmw_context_t context{rmw_get_zero_initialized_context()};
+  rmw_node_t * node{nullptr};
+  rmw_publisher_t * pub{nullptr};
+  rmw_subscription_t * sub{nullptr};
+};
+
+TEST_F(TestTakeSequence, take_less_than_a_batch) {
+  publish_all();
+  take_and_check(5u, 0u, 5u);
+  take_and_check(1u, 5u, 1u);
+}
+
+TEST_F(TestTakeSequence, take_more_than_a_batch) {
+  publish_all();
+  // Two full batches and a partial one
+  take_and_check(70u, 0u, published_count);
+  take_and_check(5u, 0u, 0u);
+}
+
+TEST_F(TestTakeSequence, take_across_batches) {
+  publish_all();
+  take_and_check(3u, 0u, 3u);
+  take_and_check(34u, 3u, 34u);
+  take_and_check(10u, 37u, 3u);
+}
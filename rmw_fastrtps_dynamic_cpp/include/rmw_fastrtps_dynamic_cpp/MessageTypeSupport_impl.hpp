@@ -62,6 +62,8 @@ MessageTypeSupport<MembersType>::MessageTypeSupport(
   }
   // Account for RTPS submessage alignment
   this->m_typeSize = (this->m_typeSize + 3) & ~3;
+
+  this->plan_.build(this->members_);
 }
 
 }  // namespace rmw_fastrtps_dynamic_cpp
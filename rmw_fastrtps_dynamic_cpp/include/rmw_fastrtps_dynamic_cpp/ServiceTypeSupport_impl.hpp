@@ -61,6 +61,8 @@ RequestTypeSupport<ServiceMembersType, MessageMembersType>::RequestTypeSupport(
   }
   // Account for RTPS submessage alignment
   this->m_typeSize = (this->m_typeSize + 3) & ~3;
+
+  this->plan_.build(this->members_);
 }
 
 template<typename ServiceMembersType, typename MessageMembersType>
@@ -94,6 +96,8 @@ ResponseTypeSupport<ServiceMembersType, MessageMembersType>::ResponseTypeSupport
   }
   // Account for RTPS submessage alignment
   this->m_typeSize = (this->m_typeSize + 3) & ~3;
+
+  this->plan_.build(this->members_);
 }
 
 }  // namespace rmw_fastrtps_dynamic_cpp
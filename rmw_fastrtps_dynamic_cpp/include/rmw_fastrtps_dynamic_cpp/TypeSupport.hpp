@@ -16,14 +16,21 @@
 #define RMW_FASTRTPS_DYNAMIC_CPP__TYPESUPPORT_HPP_
 
 #include <cassert>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include "rosidl_runtime_c/string.h"
 #include "rosidl_runtime_c/string_functions.h"
 
 #include "fastcdr/FastBuffer.h"
 #include "fastcdr/Cdr.h"
+#include "fastcdr/exceptions/NotEnoughMemoryException.h"
 
+#include "rcutils/allocator.h"
 #include "rcutils/logging_macros.h"
 
 #include "rosidl_typesupport_introspection_cpp/field_types.hpp"
@@ -48,8 +55,8 @@ namespace rmw_fastrtps_dynamic_cpp
 template<typename MembersType>
 struct StringHelper;
 
-// For C introspection typesupport we create intermediate instances of std::string so that
-// eprosima::fastcdr::Cdr can handle the string properly.
+// For C introspection typesupport the CDR string is written and read directly from the buffer of
+// the rosidl_runtime_c__String, without intermediate std::string instances.
 template<>
 struct StringHelper<rosidl_typesupport_introspection_c__MessageMembers>
 {
@@ -76,35 +83,64 @@ struct StringHelper<rosidl_typesupport_introspection_c__MessageMembers>
     return current_alignment + strlen(c_string->data) + 1;
   }
 
-  static std::string convert_to_std_string(void * data)
+  // Same encoding as eprosima::fastcdr::Cdr::serialize(const char *)
+  static void serialize(eprosima::fastcdr::Cdr & ser, const rosidl_runtime_c__String & c_string)
   {
-    auto c_string = static_cast<rosidl_runtime_c__String *>(data);
-    if (!c_string) {
-      RCUTILS_LOG_ERROR_NAMED(
-        "rmw_fastrtps_dynamic_cpp",
-        "Failed to cast data as rosidl_runtime_c__String");
-      return "";
-    }
-    if (!c_string->data) {
+    if (!c_string.data) {
       RCUTILS_LOG_ERROR_NAMED(
         "rmw_fastrtps_dynamic_cpp",
         "rosidl_generator_c_String had invalid data");
-      return "";
+      ser << static_cast<uint32_t>(1u);
+      ser << '\0';
+      return;
     }
-    return std::string(c_string->data);
+    // Stop at the first null character, as the estimate in next_field_align() and the
+    // serialization of the C++ string built from it did, and include the null terminator
+    const uint32_t length = static_cast<uint32_t>(strlen(c_string.data) + 1);
+    ser << length;
+    ser.serializeArray(c_string.data, length);
   }
 
-  static std::string convert_to_std_string(rosidl_runtime_c__String & data)
+  // Same decoding as eprosima::fastcdr::Cdr::deserialize(std::string &).
+  // The buffer of the string is only reallocated when it is too small.
+  static void assign(eprosima::fastcdr::Cdr & deser, rosidl_runtime_c__String & c_string)
   {
-    return std::string(data.data);
+    uint32_t length = 0;
+    deser >> length;
+
+    // Check the length before allocating anything for it
+    eprosima::fastcdr::Cdr::state length_state(deser);
+    if (!deser.jump(length)) {
+      using NotEnoughMemoryException = eprosima::fastcdr::exception::NotEnoughMemoryException;
+      throw NotEnoughMemoryException(NotEnoughMemoryException::NOT_ENOUGH_MEMORY_MESSAGE_DEFAULT);
+    }
+    deser.setState(length_state);
+
+    if (!c_string.data || c_string.capacity < static_cast<size_t>(length) + 1) {
+      rcutils_allocator_t allocator = rcutils_get_default_allocator();
+      auto data = static_cast<char *>(
+        allocator.reallocate(c_string.data, static_cast<size_t>(length) + 1, allocator.state));
+      if (!data) {
+        throw std::runtime_error("unable to assign rosidl_runtime_c__String");
+      }
+      c_string.data = data;
+      c_string.capacity = static_cast<size_t>(length) + 1;
+    }
+
+    size_t size = length;
+    if (length > 0) {
+      deser.deserializeArray(c_string.data, length);
+      if ('\0' == c_string.data[length - 1]) {
+        --size;
+      }
+    }
+    c_string.data[size] = '\0';
+    c_string.size = size;
   }
 
   static void assign(eprosima::fastcdr::Cdr & deser, void * field)
   {
-    std::string str;
-    deser >> str;
-    rosidl_runtime_c__String * c_str = static_cast<rosidl_runtime_c__String *>(field);
-    rosidl_runtime_c__String__assign(c_str, str.c_str());
+    assign(deser, *static_cast<rosidl_runtime_c__String *>(field));
   }
 };
 
@@ -126,6 +162,81 @@ struct StringHelper<rosidl_typesupport_introspection_cpp::MessageMembers>
   }
 };
 
+// Flat list of the operations needed to (de)serialize a message type, built once per type support.
+// Members of nested messages are flattened into the list of their parent, so the introspection
+// data is not walked on every (de)serialization. Runs of primitive members whose memory layout
+// matches their CDR representation are copied as a single block, when the endianness and the
+// alignment of the stream allow it.
+template<typename MembersType>
+class SerializationPlan
+{
+public:
+  using MemberType =
+    std::remove_const_t<std::remove_pointer_t<decltype(MembersType::members_)>>;
+
+  void build(const MembersType * members);
+
+  // origin is the position of the stream right after the encapsulation,
+  // which CDR alignment is relative to.
+  bool serialize(
+    eprosima::fastcdr::Cdr & ser, const char * origin, const void * ros_message) const;
+
+  bool deserialize(
+    eprosima::fastcdr::Cdr & deser, const char * origin, void * ros_message) const;
+
+private:
+  using FieldFunction = void (*)(const MemberType *, void *, eprosima::fastcdr::Cdr &);
+
+  enum class OperationKind
+  {
+    FIELD,
+    BLOCK,
+    MESSAGES
+  };
+
+  struct Operation
+  {
+    OperationKind kind;
+    // Offset of the field from the start of the message
+    size_t offset;
+
+    // FIELD and MESSAGES
+    const MemberType * member;
+
+    // FIELD
+    FieldFunction serialize;
+    FieldFunction deserialize;
+    // Whether the field can be part of a block, and its layout when it can
+    bool copyable;
+    size_t element_size;
+    size_t element_count;
+
+    // BLOCK, followed by the FIELD operations it replaces
+    size_t block_size;
+    size_t first_alignment;
+    size_t block_alignment;
+    size_t replaced_operations;
+
+    // MESSAGES (arrays and sequences of messages)
+    const SerializationPlan * nested_plan;
+  };
+
+  template<typename T>
+  void add_field(const MemberType * member, size_t offset, FieldFunction serialize, bool copyable);
+
+  void add_members(const MembersType * members, size_t base_offset);
+
+  void merge_blocks();
+
+  // Whether a block can be copied at the current position of the stream
+  static bool
+  can_copy_block(
+    const Operation & block, eprosima::fastcdr::Cdr & cdr, const char * origin, size_t & padding);
+
+  std::vector<Operation> operations_;
+  std::vector<std::unique_ptr<SerializationPlan>> nested_plans_;
+};
+
 class TypeSupportProxy : public rmw_fastrtps_shared_cpp::TypeSupport
 {
 public:
@@ -177,21 +288,14 @@ protected:
 
   const MembersType * members_;
 
+  // Built by the constructors of the derived classes, once members_ is set
+  SerializationPlan<MembersType> plan_;
+
 private:
   size_t getEstimatedSerializedSize(
     const MembersType * members,
     const void * ros_message,
     size_t current_alignment) const;
-
-  bool serializeROSmessage(
-    eprosima::fastcdr::Cdr & ser,
-    const MembersType * members,
-    const void * ros_message) const;
-
-  bool deserializeROSmessage(
-    eprosima::fastcdr::Cdr & deser,
-    const MembersType * members,
-    void * ros_message) const;
 };
 
 }  // namespace rmw_fastrtps_dynamic_cpp
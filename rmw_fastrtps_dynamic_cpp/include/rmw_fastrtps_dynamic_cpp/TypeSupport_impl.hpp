@@ -15,8 +15,11 @@
 #ifndef RMW_FASTRTPS_DYNAMIC_CPP__TYPESUPPORT_IMPL_HPP_
 #define RMW_FASTRTPS_DYNAMIC_CPP__TYPESUPPORT_IMPL_HPP_
 
+#include <algorithm>
 #include <cassert>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "fastcdr/Cdr.h"
@@ -28,8 +31,6 @@
 
 #include "rmw/error_handling.h"
 
-#include "rosidl_typesupport_fastrtps_c/wstring_conversion.hpp"
-#include "rosidl_typesupport_fastrtps_cpp/wstring_conversion.hpp"
 #include "rosidl_typesupport_introspection_cpp/field_types.hpp"
 #include "rosidl_typesupport_introspection_cpp/message_introspection.hpp"
 #include "rosidl_typesupport_introspection_cpp/service_introspection.hpp"
@@ -60,6 +61,44 @@ SPECIALIZE_GENERIC_C_SEQUENCE(uint32, uint32_t)
 SPECIALIZE_GENERIC_C_SEQUENCE(int64, int64_t)
 SPECIALIZE_GENERIC_C_SEQUENCE(uint64, uint64_t)
 
+// Same encoding as eprosima::fastcdr::Cdr::serialize(const std::wstring &), with every character
+// serialized as a 32 bits value, but straight from the UTF-16 buffer of the message.
+template<typename CharT>
+void serialize_u16string(eprosima::fastcdr::Cdr & ser, const CharT * data, size_t size)
+{
+  ser << static_cast<uint32_t>(size);
+  for (size_t i = 0; i < size; ++i) {
+    ser << static_cast<uint32_t>(data[i]);
+  }
+}
+
+inline void deserialize_u16string(eprosima::fastcdr::Cdr & deser, std::u16string & u16str)
+{
+  uint32_t size = 0;
+  deser >> size;
+  u16str.resize(size);
+  for (size_t i = 0; i < size; ++i) {
+    uint32_t character = 0;
+    deser >> character;
+    u16str[i] = static_cast<char16_t>(character);
+  }
+}
+
+inline void deserialize_u16string(
+  eprosima::fastcdr::Cdr & deser, rosidl_runtime_c__U16String & u16str)
+{
+  uint32_t size = 0;
+  deser >> size;
+  if (u16str.size != size && !rosidl_runtime_c__U16String__resize(&u16str, size)) {
+    throw std::runtime_error("unable to resize rosidl_runtime_c__U16String");
+  }
+  for (size_t i = 0; i < size; ++i) {
+    uint32_t character = 0;
+    deser >> character;
+    u16str.data[i] = static_cast<uint_least16_t>(character);
+  }
+}
+
 template<typename MembersType>
 TypeSupport<MembersType>::TypeSupport(const void * ros_type_support)
 : BaseTypeSupport(ros_type_support)
@@ -93,11 +132,9 @@ void serialize_field<std::wstring>(
   void * field,
   eprosima::fastcdr::Cdr & ser)
 {
-  std::wstring wstr;
   if (!member->is_array_) {
     auto u16str = static_cast<std::u16string *>(field);
-    rosidl_typesupport_fastrtps_cpp::u16string_to_wstring(*u16str, wstr);
-    ser << wstr;
+    serialize_u16string(ser, u16str->data(), u16str->size());
   } else {
     size_t size;
     if (member->array_size_ && !member->is_upper_bound_) {
@@ -109,8 +146,7 @@ void serialize_field<std::wstring>(
     for (size_t i = 0; i < size; ++i) {
       const void * element = member->get_const_function(field, i);
       auto u16str = static_cast<const std::u16string *>(element);
-      rosidl_typesupport_fastrtps_cpp::u16string_to_wstring(*u16str, wstr);
-      ser << wstr;
+      serialize_u16string(ser, u16str->data(), u16str->size());
     }
   }
 }
@@ -141,33 +177,23 @@ void serialize_field<std::string>(
 {
   using CStringHelper = StringHelper<rosidl_typesupport_introspection_c__MessageMembers>;
   if (!member->is_array_) {
-    auto && str = CStringHelper::convert_to_std_string(field);
+    auto & c_string = *static_cast<rosidl_runtime_c__String *>(field);
     // Control maximum length.
-    if (member->string_upper_bound_ && str.length() > member->string_upper_bound_ + 1) {
+    if (member->string_upper_bound_ && c_string.size > member->string_upper_bound_ + 1) {
       throw std::runtime_error("string overcomes the maximum length");
     }
-    ser << str;
+    CStringHelper::serialize(ser, c_string);
+  } else if (member->array_size_ && !member->is_upper_bound_) {
+    auto string_field = static_cast<rosidl_runtime_c__String *>(field);
+    for (size_t i = 0; i < member->array_size_; ++i) {
+      CStringHelper::serialize(ser, string_field[i]);
+    }
   } else {
-    // First, cast field to rosidl_generator_c
-    // Then convert to a std::string using StringHelper and serialize the std::string
-    if (member->array_size_ && !member->is_upper_bound_) {
-      // tmpstring is defined here and not below to avoid
-      // memory allocation in every iteration of the for loop
-      std::string tmpstring;
-      auto string_field = static_cast<rosidl_runtime_c__String *>(field);
-      for (size_t i = 0; i < member->array_size_; ++i) {
-        tmpstring = string_field[i].data;
-        ser.serialize(tmpstring);
-      }
-    } else {
-      auto & string_sequence_field =
-        *reinterpret_cast<rosidl_runtime_c__String__Sequence *>(field);
-      std::vector<std::string> cpp_string_vector;
-      for (size_t i = 0; i < string_sequence_field.size; ++i) {
-        cpp_string_vector.push_back(
-          CStringHelper::convert_to_std_string(string_sequence_field.data[i]));
-      }
-      ser << cpp_string_vector;
+    auto & string_sequence_field =
+      *reinterpret_cast<rosidl_runtime_c__String__Sequence *>(field);
+    ser << static_cast<uint32_t>(string_sequence_field.size);
+    for (size_t i = 0; i < string_sequence_field.size; ++i) {
+      CStringHelper::serialize(ser, string_sequence_field.data[i]);
     }
   }
 }
@@ -179,124 +205,36 @@ void serialize_field<std::wstring>(
   void * field,
   eprosima::fastcdr::Cdr & ser)
 {
-  std::wstring wstr;
   if (!member->is_array_) {
     auto u16str = static_cast<rosidl_runtime_c__U16String *>(field);
-    rosidl_typesupport_fastrtps_c::u16string_to_wstring(*u16str, wstr);
-    ser << wstr;
+    serialize_u16string(ser, u16str->data, u16str->size);
   } else if (member->array_size_ && !member->is_upper_bound_) {
     auto array = static_cast<rosidl_runtime_c__U16String *>(field);
     for (size_t i = 0; i < member->array_size_; ++i) {
-      rosidl_typesupport_fastrtps_c::u16string_to_wstring(array[i], wstr);
-      ser << wstr;
+      serialize_u16string(ser, array[i].data, array[i].size);
     }
   } else {
     auto sequence = static_cast<rosidl_runtime_c__U16String__Sequence *>(field);
     ser << static_cast<uint32_t>(sequence->size);
     for (size_t i = 0; i < sequence->size; ++i) {
-      rosidl_typesupport_fastrtps_c::u16string_to_wstring(sequence->data[i], wstr);
-      ser << wstr;
+      serialize_u16string(ser, sequence->data[i].data, sequence->data[i].size);
     }
   }
 }
 
-template<typename MembersType>
-bool TypeSupport<MembersType>::serializeROSmessage(
-  eprosima::fastcdr::Cdr & ser,
-  const MembersType * members,
-  const void * ros_message) const
+// Scalar booleans are not serialized as they are stored,
+// because an uninitialized value could not be deserialized
+template<typename MemberType>
+void serialize_bool_field(
+  const MemberType * member,
+  void * field,
+  eprosima::fastcdr::Cdr & ser)
 {
-  assert(members);
-  assert(ros_message);
-
-  for (uint32_t i = 0; i < members->member_count_; ++i) {
-    const auto member = members->members_ + i;
-    void * field = const_cast<char *>(static_cast<const char *>(ros_message)) + member->offset_;
-    switch (member->type_id_) {
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BOOL:
-        if (!member->is_array_) {
-          // don't cast to bool here because if the bool is
-          // uninitialized the random value can't be deserialized
-          ser << (*static_cast<uint8_t *>(field) ? true : false);
-        } else {
-          serialize_field<bool>(member, field, ser);
-        }
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
-        serialize_field<uint8_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
-        serialize_field<char>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
-        serialize_field<float>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
-        serialize_field<double>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
-        serialize_field<int16_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
-        serialize_field<uint16_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
-        serialize_field<int32_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
-        serialize_field<uint32_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
-        serialize_field<int64_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
-        serialize_field<uint64_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING:
-        serialize_field<std::string>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_WSTRING:
-        serialize_field<std::wstring>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE:
-        {
-          auto sub_members = static_cast<const MembersType *>(member->members_->data);
-          if (!member->is_array_) {
-            serializeROSmessage(ser, sub_members, field);
-          } else {
-            size_t array_size = 0;
-
-            if (member->array_size_ && !member->is_upper_bound_) {
-              array_size = member->array_size_;
-            } else {
-              if (!member->size_function) {
-                RMW_SET_ERROR_MSG("unexpected error: size function is null");
-                return false;
-              }
-              array_size = member->size_function(field);
-
-              // Serialize length
-              ser << (uint32_t)array_size;
-            }
-
-            if (array_size != 0 && !member->get_function) {
-              RMW_SET_ERROR_MSG("unexpected error: get_function function is null");
-              return false;
-            }
-            for (size_t index = 0; index < array_size; ++index) {
-              serializeROSmessage(ser, sub_members, member->get_function(field, index));
-            }
-          }
-        }
-        break;
-      default:
-        throw std::runtime_error("unknown type");
-    }
+  if (!member->is_array_) {
+    ser << (*static_cast<uint8_t *>(field) ? true : false);
+  } else {
+    serialize_field<bool>(member, field, ser);
   }
-
-  return true;
 }
 
 // C++ specialization
@@ -598,11 +536,8 @@ inline void deserialize_field<std::wstring>(
   void * field,
   eprosima::fastcdr::Cdr & deser)
 {
-  std::wstring wstr;
   if (!member->is_array_) {
-    deser >> wstr;
-    rosidl_typesupport_fastrtps_cpp::wstring_to_u16string(
-      wstr, *static_cast<std::u16string *>(field));
+    deserialize_u16string(deser, *static_cast<std::u16string *>(field));
   } else {
     uint32_t size;
     if (member->array_size_ && !member->is_upper_bound_) {
@@ -613,9 +548,7 @@ inline void deserialize_field<std::wstring>(
     }
     for (size_t i = 0; i < size; ++i) {
       void * element = member->get_function(field, i);
-      auto u16str = static_cast<std::u16string *>(element);
-      deser >> wstr;
-      rosidl_typesupport_fastrtps_cpp::wstring_to_u16string(wstr, *u16str);
+      deserialize_u16string(deser, *static_cast<std::u16string *>(element));
     }
   }
 }
@@ -645,42 +578,28 @@ inline void deserialize_field<std::string>(
   void * field,
   eprosima::fastcdr::Cdr & deser)
 {
+  using CStringHelper = StringHelper<rosidl_typesupport_introspection_c__MessageMembers>;
   if (!member->is_array_) {
-    using CStringHelper = StringHelper<rosidl_typesupport_introspection_c__MessageMembers>;
-    CStringHelper::assign(deser, field);
+    CStringHelper::assign(deser, *static_cast<rosidl_runtime_c__String *>(field));
+  } else if (member->array_size_ && !member->is_upper_bound_) {
+    auto deser_field = static_cast<rosidl_runtime_c__String *>(field);
+    for (size_t i = 0; i < member->array_size_; ++i) {
+      CStringHelper::assign(deser, deser_field[i]);
+    }
   } else {
-    if (member->array_size_ && !member->is_upper_bound_) {
-      auto deser_field = static_cast<rosidl_runtime_c__String *>(field);
-      // tmpstring is defined here and not below to avoid
-      // memory allocation in every iteration of the for loop
-      std::string tmpstring;
-      for (size_t i = 0; i < member->array_size_; ++i) {
-        deser.deserialize(tmpstring);
-        if (!rosidl_runtime_c__String__assign(&deser_field[i], tmpstring.c_str())) {
-          throw std::runtime_error("unable to assign rosidl_runtime_c__String");
-        }
-      }
-    } else {
-      std::vector<std::string> cpp_string_vector;
-      deser >> cpp_string_vector;
-
-      auto & string_sequence_field =
-        *reinterpret_cast<rosidl_runtime_c__String__Sequence *>(field);
-      if (
-        !rosidl_runtime_c__String__Sequence__init(
-          &string_sequence_field, cpp_string_vector.size()))
-      {
+    uint32_t size = 0;
+    deser >> size;
+    auto & string_sequence_field =
+      *reinterpret_cast<rosidl_runtime_c__String__Sequence *>(field);
+    // Keep the elements, and the buffers of their strings, when the size does not change
+    if (string_sequence_field.size != size) {
+      rosidl_runtime_c__String__Sequence__fini(&string_sequence_field);
+      if (!rosidl_runtime_c__String__Sequence__init(&string_sequence_field, size)) {
         throw std::runtime_error("unable to initialize rosidl_runtime_c__String array");
       }
-
-      for (size_t i = 0; i < cpp_string_vector.size(); ++i) {
-        if (
-          !rosidl_runtime_c__String__assign(
-            &string_sequence_field.data[i], cpp_string_vector[i].c_str()))
-        {
-          throw std::runtime_error("unable to assign rosidl_runtime_c__String");
-        }
-      }
+    }
+    for (size_t i = 0; i < size; ++i) {
+      CStringHelper::assign(deser, string_sequence_field.data[i]);
     }
   }
 }
@@ -691,123 +610,310 @@ inline void deserialize_field<std::wstring>(
   void * field,
   eprosima::fastcdr::Cdr & deser)
 {
-  std::wstring wstr;
   if (!member->is_array_) {
-    deser >> wstr;
-    rosidl_typesupport_fastrtps_c::wstring_to_u16string(
-      wstr, *static_cast<rosidl_runtime_c__U16String *>(field));
+    deserialize_u16string(deser, *static_cast<rosidl_runtime_c__U16String *>(field));
   } else if (member->array_size_ && !member->is_upper_bound_) {
     auto array = static_cast<rosidl_runtime_c__U16String *>(field);
     for (size_t i = 0; i < member->array_size_; ++i) {
-      deser >> wstr;
-      rosidl_typesupport_fastrtps_c::wstring_to_u16string(wstr, array[i]);
+      deserialize_u16string(deser, array[i]);
     }
   } else {
     uint32_t size;
     deser >> size;
     auto sequence = static_cast<rosidl_runtime_c__U16String__Sequence *>(field);
-    if (!rosidl_runtime_c__U16String__Sequence__init(sequence, size)) {
-      throw std::runtime_error("unable to initialize rosidl_runtime_c__U16String sequence");
+    if (sequence->size != size) {
+      rosidl_runtime_c__U16String__Sequence__fini(sequence);
+      if (!rosidl_runtime_c__U16String__Sequence__init(sequence, size)) {
+        throw std::runtime_error("unable to initialize rosidl_runtime_c__U16String sequence");
+      }
     }
     for (size_t i = 0; i < sequence->size; ++i) {
-      deser >> wstr;
-      rosidl_typesupport_fastrtps_c::wstring_to_u16string(wstr, sequence->data[i]);
+      deserialize_u16string(deser, sequence->data[i]);
     }
   }
 }
 
 template<typename MembersType>
-bool TypeSupport<MembersType>::deserializeROSmessage(
-  eprosima::fastcdr::Cdr & deser,
-  const MembersType * members,
-  void * ros_message) const
+template<typename T>
+void SerializationPlan<MembersType>::add_field(
+  const MemberType * member, size_t offset, FieldFunction serialize, bool copyable)
 {
-  assert(members);
-  assert(ros_message);
+  Operation op{};
+  op.kind = OperationKind::FIELD;
+  op.offset = offset;
+  op.member = member;
+  op.serialize = serialize;
+  op.deserialize = &deserialize_field<T>;
+  // Only single values and fixed size arrays have the same layout in memory and in CDR
+  op.copyable = copyable &&
+    (!member->is_array_ || (member->array_size_ && !member->is_upper_bound_));
+  op.element_size = sizeof(T);
+  op.element_count = member->is_array_ ? member->array_size_ : 1u;
+  operations_.push_back(op);
+}
 
+template<typename MembersType>
+void SerializationPlan<MembersType>::add_members(const MembersType * members, size_t base_offset)
+{
   for (uint32_t i = 0; i < members->member_count_; ++i) {
     const auto * member = members->members_ + i;
-    void * field = static_cast<char *>(ros_message) + member->offset_;
+    size_t offset = base_offset + member->offset_;
     switch (member->type_id_) {
       case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BOOL:
-        deserialize_field<bool>(member, field, deser);
+        add_field<bool>(member, offset, &serialize_bool_field<MemberType>, false);
         break;
       case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
       case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
-        deserialize_field<uint8_t>(member, field, deser);
+        add_field<uint8_t>(member, offset, &serialize_field<uint8_t>, true);
         break;
       case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
       case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
-        deserialize_field<char>(member, field, deser);
+        add_field<char>(member, offset, &serialize_field<char>, true);
         break;
       case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
-        deserialize_field<float>(member, field, deser);
+        add_field<float>(member, offset, &serialize_field<float>, true);
         break;
       case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
-        deserialize_field<double>(member, field, deser);
+        add_field<double>(member, offset, &serialize_field<double>, true);
         break;
       case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
-        deserialize_field<int16_t>(member, field, deser);
+        add_field<int16_t>(member, offset, &serialize_field<int16_t>, true);
         break;
       case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
-        deserialize_field<uint16_t>(member, field, deser);
+        add_field<uint16_t>(member, offset, &serialize_field<uint16_t>, true);
         break;
       case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
-        deserialize_field<int32_t>(member, field, deser);
+        add_field<int32_t>(member, offset, &serialize_field<int32_t>, true);
         break;
       case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
-        deserialize_field<uint32_t>(member, field, deser);
+        add_field<uint32_t>(member, offset, &serialize_field<uint32_t>, true);
         break;
       case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
-        deserialize_field<int64_t>(member, field, deser);
+        add_field<int64_t>(member, offset, &serialize_field<int64_t>, true);
         break;
       case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
-        deserialize_field<uint64_t>(member, field, deser);
+        add_field<uint64_t>(member, offset, &serialize_field<uint64_t>, true);
         break;
       case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING:
-        deserialize_field<std::string>(member, field, deser);
+        add_field<std::string>(member, offset, &serialize_field<std::string>, false);
         break;
       case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_WSTRING:
-        deserialize_field<std::wstring>(member, field, deser);
+        add_field<std::wstring>(member, offset, &serialize_field<std::wstring>, false);
         break;
       case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE:
         {
           auto sub_members = static_cast<const MembersType *>(member->members_->data);
           if (!member->is_array_) {
-            if (!deserializeROSmessage(deser, sub_members, field)) {
+            // Nested messages are flattened
+            add_members(sub_members, offset);
+          } else {
+            auto nested_plan = std::make_unique<SerializationPlan>();
+            nested_plan->build(sub_members);
+
+            Operation op{};
+            op.kind = OperationKind::MESSAGES;
+            op.offset = offset;
+            op.member = member;
+            op.nested_plan = nested_plan.get();
+            operations_.push_back(op);
+            nested_plans_.push_back(std::move(nested_plan));
+          }
+        }
+        break;
+      default:
+        throw std::runtime_error("unknown type");
+    }
+  }
+}
+
+template<typename MembersType>
+void SerializationPlan<MembersType>::merge_blocks()
+{
+  std::vector<Operation> merged;
+  merged.reserve(operations_.size());
+
+  size_t i = 0;
+  while (i < operations_.size()) {
+    if (OperationKind::FIELD != operations_[i].kind || !operations_[i].copyable) {
+      merged.push_back(operations_[i++]);
+      continue;
+    }
+
+    // Lay out the run in CDR as if the stream was positioned like the memory of the message.
+    // The run continues while every field lands at the same place in both.
+    const Operation & first = operations_[i];
+    size_t cdr_position = first.offset + first.element_size * first.element_count;
+    size_t block_alignment = first.element_size;
+    size_t end = i + 1;
+    while (end < operations_.size() &&
+      OperationKind::FIELD == operations_[end].kind && operations_[end].copyable)
+    {
+      const Operation & next = operations_[end];
+      size_t aligned_position = cdr_position +
+        eprosima::fastcdr::Cdr::alignment(cdr_position, next.element_size);
+      if (aligned_position != next.offset) {
+        break;
+      }
+      cdr_position = next.offset + next.element_size * next.element_count;
+      block_alignment = std::max(block_alignment, next.element_size);
+      ++end;
+    }
+
+    if (end - i > 1) {
+      Operation block{};
+      block.kind = OperationKind::BLOCK;
+      block.offset = first.offset;
+      block.block_size = cdr_position - first.offset;
+      block.first_alignment = first.element_size;
+      block.block_alignment = block_alignment;
+      block.replaced_operations = end - i;
+      merged.push_back(block);
+    }
+    // The fields are kept after the block, to be used when it cannot be copied
+    merged.insert(merged.end(), operations_.begin() + i, operations_.begin() + end);
+    i = end;
+  }
+
+  operations_ = std::move(merged);
+}
+
+template<typename MembersType>
+void SerializationPlan<MembersType>::build(const MembersType * members)
+{
+  assert(members);
+  operations_.clear();
+  nested_plans_.clear();
+  add_members(members, 0u);
+  merge_blocks();
+}
+
+template<typename MembersType>
+bool SerializationPlan<MembersType>::can_copy_block(
+  const Operation & block, eprosima::fastcdr::Cdr & cdr, const char * origin, size_t & padding)
+{
+  if (cdr.endianness() != eprosima::fastcdr::Cdr::DEFAULT_ENDIAN) {
+    return false;
+  }
+  size_t position = static_cast<size_t>(cdr.getCurrentPosition() - origin);
+  padding = eprosima::fastcdr::Cdr::alignment(position, block.first_alignment);
+  return (position + padding) % block.block_alignment == block.offset % block.block_alignment;
+}
+
+template<typename MembersType>
+bool SerializationPlan<MembersType>::serialize(
+  eprosima::fastcdr::Cdr & ser, const char * origin, const void * ros_message) const
+{
+  assert(ros_message);
+
+  for (size_t i = 0; i < operations_.size(); ++i) {
+    const Operation & op = operations_[i];
+    void * field = const_cast<char *>(static_cast<const char *>(ros_message)) + op.offset;
+    switch (op.kind) {
+      case OperationKind::FIELD:
+        op.serialize(op.member, field, ser);
+        break;
+      case OperationKind::BLOCK:
+        {
+          size_t padding = 0;
+          // Otherwise the fields of the block are processed one by one
+          if (can_copy_block(op, ser, origin, padding) &&
+            (0u == padding || ser.jump(padding)))
+          {
+            ser.serializeArray(static_cast<const char *>(field), op.block_size);
+            i += op.replaced_operations;
+          }
+        }
+        break;
+      case OperationKind::MESSAGES:
+        {
+          const auto * member = op.member;
+          size_t array_size = 0;
+
+          if (member->array_size_ && !member->is_upper_bound_) {
+            array_size = member->array_size_;
+          } else {
+            if (!member->size_function) {
+              RMW_SET_ERROR_MSG("unexpected error: size function is null");
               return false;
             }
-          } else {
-            size_t array_size = 0;
+            array_size = member->size_function(field);
 
-            if (member->array_size_ && !member->is_upper_bound_) {
-              array_size = member->array_size_;
-            } else {
-              uint32_t num_elems = 0;
-              deser >> num_elems;
-              array_size = static_cast<size_t>(num_elems);
+            // Serialize length
+            ser << (uint32_t)array_size;
+          }
 
-              if (!member->resize_function) {
-                RMW_SET_ERROR_MSG("unexpected error: resize function is null");
-                return false;
-              }
-              member->resize_function(field, array_size);
+          if (array_size != 0 && !member->get_function) {
+            RMW_SET_ERROR_MSG("unexpected error: get_function function is null");
+            return false;
+          }
+          for (size_t index = 0; index < array_size; ++index) {
+            if (!op.nested_plan->serialize(ser, origin, member->get_function(field, index))) {
+              return false;
             }
+          }
+        }
+        break;
+    }
+  }
 
-            if (array_size != 0 && !member->get_function) {
-              RMW_SET_ERROR_MSG("unexpected error: get_function function is null");
+  return true;
+}
+
+template<typename MembersType>
+bool SerializationPlan<MembersType>::deserialize(
+  eprosima::fastcdr::Cdr & deser, const char * origin, void * ros_message) const
+{
+  assert(ros_message);
+
+  for (size_t i = 0; i < operations_.size(); ++i) {
+    const Operation & op = operations_[i];
+    void * field = static_cast<char *>(ros_message) + op.offset;
+    switch (op.kind) {
+      case OperationKind::FIELD:
+        op.deserialize(op.member, field, deser);
+        break;
+      case OperationKind::BLOCK:
+        {
+          size_t padding = 0;
+          // Otherwise the fields of the block are processed one by one
+          if (can_copy_block(op, deser, origin, padding) &&
+            (0u == padding || deser.jump(padding)))
+          {
+            deser.deserializeArray(static_cast<char *>(field), op.block_size);
+            i += op.replaced_operations;
+          }
+        }
+        break;
+      case OperationKind::MESSAGES:
+        {
+          const auto * member = op.member;
+          size_t array_size = 0;
+
+          if (member->array_size_ && !member->is_upper_bound_) {
+            array_size = member->array_size_;
+          } else {
+            uint32_t num_elems = 0;
+            deser >> num_elems;
+            array_size = static_cast<size_t>(num_elems);
+
+            if (!member->resize_function) {
+              RMW_SET_ERROR_MSG("unexpected error: resize function is null");
               return false;
             }
-            for (size_t index = 0; index < array_size; ++index) {
-              if (!deserializeROSmessage(deser, sub_members, member->get_function(field, index))) {
-                return false;
-              }
+            member->resize_function(field, array_size);
+          }
+
+          if (array_size != 0 && !member->get_function) {
+            RMW_SET_ERROR_MSG("unexpected error: get_function function is null");
+            return false;
+          }
+          for (size_t index = 0; index < array_size; ++index) {
+            if (!op.nested_plan->deserialize(deser, origin, member->get_function(field, index))) {
+              return false;
             }
           }
         }
         break;
-      default:
-        throw std::runtime_error("unknown type");
     }
   }
 
@@ -935,7 +1041,10 @@ bool TypeSupport<MembersType>::serializeROSmessage(
 
   (void)impl;
   if (members_->member_count_ != 0) {
-    TypeSupport::serializeROSmessage(ser, members_, ros_message);
+    // CDR alignment is relative to the end of the encapsulation
+    if (!plan_.serialize(ser, ser.getCurrentPosition(), ros_message)) {
+      return false;
+    }
   } else {
     ser << (uint8_t)0;
   }
@@ -956,7 +1065,8 @@ bool TypeSupport<MembersType>::deserializeROSmessage(
 
     (void)impl;
     if (members_->member_count_ != 0) {
-      return TypeSupport::deserializeROSmessage(deser, members_, ros_message);
+      // CDR alignment is relative to the end of the encapsulation
+      return plan_.deserialize(deser, deser.getCurrentPosition(), ros_message);
     }
 
     uint8_t dump = 0;
@@ -0,0 +1,74 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RMW_FASTRTPS_DYNAMIC_CPP__LOANED_MESSAGE_SEQUENCE_HPP_
+#define RMW_FASTRTPS_DYNAMIC_CPP__LOANED_MESSAGE_SEQUENCE_HPP_
+
+#include <cstddef>
+
+#include "rmw/rmw.h"
+#include "rmw_fastrtps_dynamic_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_dynamic_cpp
+{
+
+/// Loan up to `count` messages from a subscription with a single take.
+/**
+ * Drains the samples of plain message types in bursts without copying them, and locking the
+ * DataReader once per burst instead of once per sample.
+ *
+ * The first `taken` elements of `message_sequence` point to the loaned messages, and the first
+ * `taken` elements of `message_info_sequence` hold their info, if it is not null.
+ * All of them are a single loan, which must be given back with return_loaned_message_sequence().
+ *
+ * \param[in] subscription Subscription to take from.
+ * \param[in] count Maximum number of messages to loan.
+ * \param[inout] message_sequence Sequence with a capacity of at least `count` messages.
+ * \param[inout] message_info_sequence Sequence with a capacity of at least `count` infos,
+ *   or null.
+ * \param[out] taken Number of messages loaned, which is 0 if there were no messages to take.
+ * \return `RMW_RET_OK` if successful, or
+ * \return `RMW_RET_INVALID_ARGUMENT` if an argument is invalid, or
+ * \return `RMW_RET_INCORRECT_RMW_IMPLEMENTATION` if the subscription is from a different
+ *   rmw implementation, or
+ * \return `RMW_RET_UNSUPPORTED` if the subscription cannot loan messages, or
+ * \return `RMW_RET_ERROR` if too many loans are outstanding on the subscription.
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+take_loaned_message_sequence(
+  const rmw_subscription_t * subscription,
+  size_t count,
+  rmw_message_sequence_t * message_sequence,
+  rmw_message_info_sequence_t * message_info_sequence,
+  size_t * taken);
+
+/// Give back the messages loaned by take_loaned_message_sequence().
+/**
+ * On success, the size of `message_sequence` is set to 0.
+ *
+ * \return `RMW_RET_OK` if successful, or
+ * \return `RMW_RET_INVALID_ARGUMENT` if `message_sequence` is empty, or
+ * \return `RMW_RET_ERROR` if the messages were not loaned by this subscription.
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+return_loaned_message_sequence(
+  const rmw_subscription_t * subscription,
+  rmw_message_sequence_t * message_sequence);
+
+}  // namespace rmw_fastrtps_dynamic_cpp
+
+#endif  // RMW_FASTRTPS_DYNAMIC_CPP__LOANED_MESSAGE_SEQUENCE_HPP_
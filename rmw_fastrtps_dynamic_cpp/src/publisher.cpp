@@ -13,6 +13,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <memory>
 #include <string>
 
 #include "fastdds/dds/core/policy/QosPolicies.hpp"
@@ -37,6 +38,7 @@
 
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_publisher_info.hpp"
+#include "rmw_fastrtps_shared_cpp/loaned_message_pool.hpp"
 #include "rmw_fastrtps_shared_cpp/names.hpp"
 #include "rmw_fastrtps_shared_cpp/namespace_prefix.hpp"
 #include "rmw_fastrtps_shared_cpp/qos.hpp"
@@ -254,11 +256,18 @@ rmw_fastrtps_dynamic_cpp::create_publisher(
     } else if (participant_info->publishing_mode == publishing_mode_t::SYNCHRONOUS) {
       writer_qos.publish_mode().kind = eprosima::fastrtps::SYNCHRONOUS_PUBLISH_MODE;
     }
+    rmw_fastrtps_shared_cpp::use_flow_controller(participant_info, topic_name, writer_qos);
 
     writer_qos.endpoint().history_memory_policy =
       eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
 
-    writer_qos.data_sharing().off();
+    if (rmw_fastrtps_shared_cpp::use_data_sharing(
+        participant_info, topic_name, info->type_support_))
+    {
+      writer_qos.data_sharing().automatic();
+    } else {
+      writer_qos.data_sharing().off();
+    }
   }
 
   // Get QoS from RMW
@@ -270,12 +279,17 @@ rmw_fastrtps_dynamic_cpp::create_publisher(
     return nullptr;
   }
 
+  // Writers lending their buffers let serialized messages be published without being copied
+  info->payload_pool_ = rmw_fastrtps_shared_cpp::create_payload_pool(
+    participant_info, topic_name, writer_qos);
+
   // Creates DataWriter (with publisher name to not change name policy)
   info->data_writer_ = publisher->create_datawriter(
     info->topic_,
     writer_qos,
     info->data_writer_listener_,
-    eprosima::fastdds::dds::StatusMask::publication_matched());
+    eprosima::fastdds::dds::StatusMask::publication_matched(),
+    info->payload_pool_);
 
   if (!info->data_writer_) {
     RMW_SET_ERROR_MSG("create_publisher() could not create data writer");
@@ -310,6 +324,12 @@ rmw_fastrtps_dynamic_cpp::create_publisher(
     });
 
   rmw_publisher->can_loan_messages = info->type_support_->is_plain();
+  if (!rmw_publisher->can_loan_messages && info->type_support_->is_bounded()) {
+    // Bounded types are loaned from a pool of messages owned by the publisher
+    info->loan_pool_ = rmw_fastrtps_shared_cpp::LoanedMessagePool::create(
+      type_supports, participant_info->loaned_message_pool_size);
+    rmw_publisher->can_loan_messages = nullptr != info->loan_pool_;
+  }
   rmw_publisher->implementation_identifier = eprosima_fastrtps_identifier;
   rmw_publisher->data = info;
 
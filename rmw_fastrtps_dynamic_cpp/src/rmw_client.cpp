@@ -201,6 +201,10 @@ rmw_create_client(
 
   auto cleanup_info = rcpputils::make_scope_exit(
     [info, participant_info]() {
+      if (info->response_filtered_topic_) {
+        participant_info->participant_->delete_contentfilteredtopic(
+          info->response_filtered_topic_);
+      }
       rmw_fastrtps_shared_cpp::remove_topic_and_type(
         participant_info, nullptr, info->response_topic_, info->response_type_support_);
       rmw_fastrtps_shared_cpp::remove_topic_and_type(
@@ -305,7 +309,15 @@ rmw_create_client(
     return nullptr;
   }
 
-  response_topic_desc = info->response_topic_;
+  // Only receive the responses to the requests of this client
+  if (!rmw_fastrtps_shared_cpp::create_response_filtered_topic(
+      dds_participant, info->response_topic_, &info->response_filtered_topic_))
+  {
+    RMW_SET_ERROR_MSG("create_client() failed to create response contentfilteredtopic");
+    return nullptr;
+  }
+
+  response_topic_desc = info->response_filtered_topic_;
 
   // Create request topic
   info->request_topic_ = participant_info->find_or_create_topic(
@@ -359,7 +371,8 @@ rmw_create_client(
     response_topic_desc,
     reader_qos,
     info->listener_,
-    eprosima::fastdds::dds::StatusMask::subscription_matched());
+    eprosima::fastdds::dds::StatusMask::subscription_matched() <<
+    eprosima::fastdds::dds::StatusMask::data_available());
 
   if (!info->response_reader_) {
     RMW_SET_ERROR_MSG("create_client() failed to create response DataReader");
@@ -487,11 +500,7 @@ rmw_create_client(
     rmw_dds_common::msg::ParticipantEntitiesInfo msg =
       common_context->graph_cache.associate_reader(
       response_subscriber_gid, common_context->gid, node->name, node->namespace_);
-    rmw_ret_t rmw_ret = rmw_fastrtps_shared_cpp::__rmw_publish(
-      eprosima_fastrtps_identifier,
-      common_context->pub,
-      static_cast<void *>(&msg),
-      nullptr);
+    rmw_ret_t rmw_ret = node->context->impl->graph_update_publisher->publish(msg);
     if (RMW_RET_OK != rmw_ret) {
       common_context->graph_cache.dissociate_reader(
         response_subscriber_gid,
@@ -109,11 +109,7 @@ rmw_create_publisher(
     rmw_dds_common::msg::ParticipantEntitiesInfo msg =
       common_context->graph_cache.associate_writer(
       info->publisher_gid, common_context->gid, node->name, node->namespace_);
-    rmw_ret_t rmw_ret = rmw_fastrtps_shared_cpp::__rmw_publish(
-      eprosima_fastrtps_identifier,
-      common_context->pub,
-      static_cast<void *>(&msg),
-      nullptr);
+    rmw_ret_t rmw_ret = node->context->impl->graph_update_publisher->publish(msg);
     if (RMW_RET_OK != rmw_ret) {
       rmw_error_state_t error_state = *rmw_get_error_state();
       rmw_reset_error();
@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <mutex>
+#include <unordered_map>
+
 #include "fastcdr/FastBuffer.h"
 
 #include "rmw/error_handling.h"
@@ -21,13 +24,31 @@
 #include "./type_support_common.hpp"
 #include "./type_support_registry.hpp"
 
-extern "C"
+namespace
 {
-rmw_ret_t
-rmw_serialize(
-  const void * ros_message,
-  const rosidl_message_type_support_t * type_support,
-  rmw_serialized_message_t * serialized_message)
+
+// Type supports used by rmw_(de)serialize are taken from the registry on the first
+// (de)serialization of each type, and kept until the registry is destroyed.
+type_support_ptr
+get_message_type_support(const rosidl_message_type_support_t * ts)
+{
+  static std::mutex mutex;
+  static std::unordered_map<const rosidl_message_type_support_t *, type_support_ptr> types;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  type_support_ptr & tss = types[ts];
+  if (!tss) {
+    tss = TypeSupportRegistry::get_instance().get_message_type_support(ts);
+    if (!tss) {
+      types.erase(ts);
+      return nullptr;
+    }
+  }
+  return tss;
+}
+
+const rosidl_message_type_support_t *
+get_introspection_type_support(const rosidl_message_type_support_t * type_support)
 {
   const rosidl_message_type_support_t * ts = get_message_typesupport_handle(
     type_support, rosidl_typesupport_introspection_c__identifier);
@@ -36,17 +57,34 @@ rmw_serialize(
       type_support, rosidl_typesupport_introspection_cpp::typesupport_identifier);
     if (!ts) {
       RMW_SET_ERROR_MSG("type support not from this implementation");
-      return RMW_RET_ERROR;
     }
   }
+  return ts;
+}
+
+}  // namespace
+
+extern "C"
+{
+rmw_ret_t
+rmw_serialize(
+  const void * ros_message,
+  const rosidl_message_type_support_t * type_support,
+  rmw_serialized_message_t * serialized_message)
+{
+  const rosidl_message_type_support_t * ts = get_introspection_type_support(type_support);
+  if (!ts) {
+    return RMW_RET_ERROR;
+  }
 
-  TypeSupportRegistry & type_registry = TypeSupportRegistry::get_instance();
-  auto tss = type_registry.get_message_type_support(ts);
+  auto tss = get_message_type_support(ts);
+  if (!tss) {
+    return RMW_RET_ERROR;
+  }
   auto data_length = tss->getEstimatedSerializedSize(ros_message, ts->data);
   if (serialized_message->buffer_capacity < data_length) {
     if (rmw_serialized_message_resize(serialized_message, data_length) != RMW_RET_OK) {
       RMW_SET_ERROR_MSG("unable to dynamically resize serialized message");
-      type_registry.return_message_type_support(ts);
       return RMW_RET_ERROR;
     }
   }
@@ -59,8 +97,6 @@ rmw_serialize(
 
   auto ret = tss->serializeROSmessage(ros_message, ser, ts->data);
   serialized_message->buffer_length = data_length;
-  serialized_message->buffer_capacity = data_length;
-  type_registry.return_message_type_support(ts);
   return ret == true ? RMW_RET_OK : RMW_RET_ERROR;
 }
 
@@ -70,36 +106,51 @@ rmw_deserialize(
   const rosidl_message_type_support_t * type_support,
   void * ros_message)
 {
-  const rosidl_message_type_support_t * ts = get_message_typesupport_handle(
-    type_support, rosidl_typesupport_introspection_c__identifier);
+  const rosidl_message_type_support_t * ts = get_introspection_type_support(type_support);
   if (!ts) {
-    ts = get_message_typesupport_handle(
-      type_support, rosidl_typesupport_introspection_cpp::typesupport_identifier);
-    if (!ts) {
-      RMW_SET_ERROR_MSG("type support not from this implementation");
-      return RMW_RET_ERROR;
-    }
+    return RMW_RET_ERROR;
   }
 
-  TypeSupportRegistry & type_registry = TypeSupportRegistry::get_instance();
-  auto tss = type_registry.get_message_type_support(ts);
+  auto tss = get_message_type_support(ts);
+  if (!tss) {
+    return RMW_RET_ERROR;
+  }
   eprosima::fastcdr::FastBuffer buffer(
     reinterpret_cast<char *>(serialized_message->buffer), serialized_message->buffer_length);
   eprosima::fastcdr::Cdr deser(buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN,
     eprosima::fastcdr::Cdr::DDS_CDR);
 
   auto ret = tss->deserializeROSmessage(deser, ros_message, ts->data);
-  type_registry.return_message_type_support(ts);
   return ret == true ? RMW_RET_OK : RMW_RET_ERROR;
 }
 
 rmw_ret_t
 rmw_get_serialized_message_size(
-  const rosidl_message_type_support_t * /*type_support*/,
-  const rosidl_runtime_c__Sequence__bound * /*message_bounds*/,
-  size_t * /*size*/)
+  const rosidl_message_type_support_t * type_support,
+  const rosidl_runtime_c__Sequence__bound * message_bounds,
+  size_t * size)
 {
-  RMW_SET_ERROR_MSG("unimplemented");
-  return RMW_RET_UNSUPPORTED;
+  RMW_CHECK_ARGUMENT_FOR_NULL(type_support, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(size, RMW_RET_INVALID_ARGUMENT);
+  // Type supports do not provide the size of the elements of a sequence bound
+  (void)message_bounds;
+
+  const rosidl_message_type_support_t * ts = get_introspection_type_support(type_support);
+  if (!ts) {
+    return RMW_RET_ERROR;
+  }
+
+  auto tss = get_message_type_support(ts);
+  if (!tss) {
+    return RMW_RET_ERROR;
+  }
+  if (!tss->is_bounded()) {
+    RMW_SET_ERROR_MSG("serialized size of unbounded message types is not supported");
+    return RMW_RET_UNSUPPORTED;
+  }
+
+  // Same size used for the samples of the type, including the encapsulation
+  *size = tss->m_typeSize;
+  return RMW_RET_OK;
 }
 }  // extern "C"
@@ -263,7 +263,13 @@ create_subscription(
     reader_qos.endpoint().history_memory_policy =
       eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
 
-    reader_qos.data_sharing().off();
+    if (rmw_fastrtps_shared_cpp::use_data_sharing(
+        participant_info, topic_name, info->type_support_))
+    {
+      reader_qos.data_sharing().automatic();
+    } else {
+      reader_qos.data_sharing().off();
+    }
   }
 
   if (!get_datareader_qos(
@@ -274,6 +280,12 @@ create_subscription(
     return nullptr;
   }
 
+  if (info->type_support_->m_isGetKeyDefined) {
+    // Keep the history of every instance, however many there are
+    reader_qos.resource_limits().max_instances = 0;
+    reader_qos.resource_limits().max_samples = 0;
+  }
+
   eprosima::fastdds::dds::DataReaderQos original_qos = reader_qos;
   switch (subscription_options->require_unique_network_flow_endpoints) {
     default:
@@ -300,7 +312,8 @@ create_subscription(
     des_topic,
     reader_qos,
     info->data_reader_listener_,
-    eprosima::fastdds::dds::StatusMask::subscription_matched());
+    eprosima::fastdds::dds::StatusMask::subscription_matched() <<
+    eprosima::fastdds::dds::StatusMask::data_available());
   if (!info->data_reader_ &&
     (RMW_UNIQUE_NETWORK_FLOW_ENDPOINTS_OPTIONALLY_REQUIRED ==
     subscription_options->require_unique_network_flow_endpoints))
@@ -309,7 +322,8 @@ create_subscription(
       des_topic,
       original_qos,
       info->data_reader_listener_,
-      eprosima::fastdds::dds::StatusMask::subscription_matched());
+      eprosima::fastdds::dds::StatusMask::subscription_matched() <<
+      eprosima::fastdds::dds::StatusMask::data_available());
   }
 
   if (!info->data_reader_) {
@@ -23,6 +23,8 @@ TypeSupportProxy::TypeSupportProxy(rmw_fastrtps_shared_cpp::TypeSupport * inner_
   m_typeSize = inner_type->m_typeSize;
   is_plain_ = inner_type->is_plain();
   max_size_bound_ = inner_type->is_bounded();
+  // Walking the introspection data to estimate the size costs as much as serializing
+  size_by_serializing_ = true;
 }
 
 size_t TypeSupportProxy::getEstimatedSerializedSize(
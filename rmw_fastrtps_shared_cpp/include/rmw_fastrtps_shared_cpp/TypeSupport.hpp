@@ -16,6 +16,8 @@
 #define RMW_FASTRTPS_SHARED_CPP__TYPESUPPORT_HPP_
 
 #include <cassert>
+#include <cstddef>
+#include <memory>
 #include <string>
 
 #include "fastdds/dds/topic/TopicDataType.hpp"
@@ -32,6 +34,17 @@
 
 #include "./visibility_control.h"
 
+namespace eprosima
+{
+namespace fastrtps
+{
+namespace types
+{
+class DynamicPubSubType;
+}  // namespace types
+}  // namespace fastrtps
+}  // namespace eprosima
+
 namespace rmw_fastrtps_shared_cpp
 {
 
@@ -39,7 +52,13 @@ enum SerializedDataType
 {
   FASTRTPS_SERIALIZED_DATA_TYPE_CDR_BUFFER,
   FASTRTPS_SERIALIZED_DATA_TYPE_DYNAMIC_MESSAGE,
-  FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE
+  FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE,
+  // The data is a rmw_serialized_message_t, holding the whole payload
+  FASTRTPS_SERIALIZED_DATA_TYPE_SERIALIZED_MESSAGE,
+  // The data is a RosMessageCursor, only used to deserialize
+  FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE_CURSOR,
+  // The sample is dropped without being deserialized, the data is not used
+  FASTRTPS_SERIALIZED_DATA_TYPE_DISCARD
 };
 
 // Publishers write method will receive a pointer to this struct
@@ -50,6 +69,17 @@ struct SerializedData
   const void * impl;  // RMW implementation specific data
 };
 
+// ROS messages the samples of a batched take are deserialized into, in order.
+// Every element of the data collection passed to the take points to the same SerializedData,
+// so invalid samples, which are not deserialized, leave no gap between the messages.
+struct RosMessageCursor
+{
+  void * const * messages;
+  size_t count;
+  // Index of the message the next sample goes into
+  size_t next;
+};
+
 class TypeSupport : public eprosima::fastdds::dds::TopicDataType
 {
 public:
@@ -61,15 +91,18 @@ public:
   virtual bool deserializeROSmessage(
     eprosima::fastcdr::Cdr & deser, void * ros_message, const void * impl) const = 0;
 
+  /// Compute the instance handle of a sample of a keyed type.
+  /**
+   * The key of a sample is made of its first key_size bytes once serialized, after the
+   * encapsulation, see set_key_size().
+   *
+   * \return false if the type is not keyed, or the key could not be computed.
+   */
   RMW_FASTRTPS_SHARED_CPP_PUBLIC
   bool getKey(
     void * data,
     eprosima::fastrtps::rtps::InstanceHandle_t * ihandle,
-    bool force_md5 = false) override
-  {
-    (void)data; (void)ihandle; (void)force_md5;
-    return false;
-  }
+    bool force_md5 = false) override;
 
   RMW_FASTRTPS_SHARED_CPP_PUBLIC
   bool serialize(void * data, eprosima::fastrtps::rtps::SerializedPayload_t * payload) override;
@@ -104,8 +137,19 @@ public:
     return is_plain_;
   }
 
+  /// Make the type keyed on its first members, which take key_size bytes once serialized.
+  /**
+   * ROS messages do not designate key members, so the caller creating a keyed topic tells how
+   * many bytes after the encapsulation they take.
+   * Those members must have a fixed size and be serialized the same way on both endiannesses,
+   * as arrays of octets are, so their serialization is taken as the key.
+   * Must be called before the type is registered.
+   */
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  void set_key_size(size_t key_size);
+
   RMW_FASTRTPS_SHARED_CPP_PUBLIC
-  virtual ~TypeSupport() {}
+  virtual ~TypeSupport();
 
 protected:
   RMW_FASTRTPS_SHARED_CPP_PUBLIC
@@ -113,6 +157,15 @@ protected:
 
   bool max_size_bound_;
   bool is_plain_;
+  // Whether the size of non-plain ROS messages is computed by serializing them into a scratch
+  // buffer, which is then copied into the payload, instead of with getEstimatedSerializedSize.
+  bool size_by_serializing_;
+  // Serialized size of the key members, 0 when the type is not keyed
+  size_t key_size_;
+
+private:
+  // (De)serializes FASTRTPS_SERIALIZED_DATA_TYPE_DYNAMIC_MESSAGE samples
+  std::unique_ptr<eprosima::fastrtps::types::DynamicPubSubType> dynamic_pubsub_type_;
 };
 
 RMW_FASTRTPS_SHARED_CPP_PUBLIC
@@ -0,0 +1,149 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__COALESCED_ACTION_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__COALESCED_ACTION_HPP_
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+#include "rcpputils/thread_safety_annotations.hpp"
+
+#include "rmw/ret_types.h"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Runs an action at most once per period, coalescing the requests made in between.
+/**
+ * A request runs the action right away if it did not run during the last period.
+ * Otherwise the request is kept pending, and the action runs once at the end of the period, from
+ * run_pending(), for all the requests made in the meantime.
+ * So no request is served later than one period after it was made.
+ *
+ * Whoever calls run_pending() is woken up, by calling the wake function, when a request becomes
+ * pending, and is expected to call it again at get_pending_deadline().
+ *
+ * The action and the wake function are called with the internal mutex held, so requests are
+ * served in order.
+ */
+class CoalescedAction
+{
+public:
+  using Clock = std::chrono::steady_clock;
+  using Function = std::function<rmw_ret_t()>;
+  using NowFunction = std::function<Clock::time_point()>;
+
+  /// Constructor.
+  /**
+   * \param period minimum interval between two runs of the action
+   * \param action action to run
+   * \param wake called when a request becomes pending
+   * \param now clock the period is measured with, which tests can replace
+   */
+  CoalescedAction(
+    Clock::duration period,
+    Function action,
+    Function wake,
+    NowFunction now = &Clock::now)
+  : period_(period),
+    action_(std::move(action)),
+    wake_(std::move(wake)),
+    now_(std::move(now)),
+    last_run_(now_() - period_)
+  {
+  }
+
+  /// Request the action to run.
+  /**
+   * \param immediately run the action right away, along with the pending request if any,
+   *   even if it already ran during the last period
+   * \return the result of the action if it ran, of the wake function if the request became
+   *   pending, RMW_RET_OK if it joined an already pending request
+   */
+  rmw_ret_t
+  request(bool immediately = false)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (immediately || (!has_pending_request_ && now_() - last_run_ >= period_)) {
+      return run_locked();
+    }
+    if (has_pending_request_) {
+      return RMW_RET_OK;
+    }
+    has_pending_request_ = true;
+    return wake_();
+  }
+
+  /// Run the action for the pending request, if any, once the period has elapsed.
+  rmw_ret_t
+  run_pending()
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (!has_pending_request_ || now_() - last_run_ < period_) {
+      return RMW_RET_OK;
+    }
+    return run_locked();
+  }
+
+  /// Run the action for the pending request, if any, right away.
+  rmw_ret_t
+  flush()
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (!has_pending_request_) {
+      return RMW_RET_OK;
+    }
+    return run_locked();
+  }
+
+  /// Time at which the action has to run for the pending request.
+  /**
+   * \return false if there is no pending request.
+   */
+  bool
+  get_pending_deadline(Clock::time_point & deadline)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (!has_pending_request_) {
+      return false;
+    }
+    deadline = last_run_ + period_;
+    return true;
+  }
+
+private:
+  rmw_ret_t
+  run_locked() RCPPUTILS_TSA_REQUIRES(mutex_)
+  {
+    has_pending_request_ = false;
+    last_run_ = now_();
+    return action_();
+  }
+
+  const Clock::duration period_;
+  const Function action_;
+  const Function wake_;
+  const NowFunction now_;
+
+  std::mutex mutex_;
+  bool has_pending_request_ RCPPUTILS_TSA_GUARDED_BY(mutex_) {false};
+  Clock::time_point last_run_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__COALESCED_ACTION_HPP_
@@ -16,7 +16,6 @@
 #define RMW_FASTRTPS_SHARED_CPP__CUSTOM_CLIENT_INFO_HPP_
 
 #include <memory>
-#include <mutex>
 #include <set>
 #include <utility>
 #include <string>
@@ -31,6 +30,7 @@
 #include "fastdds/dds/subscriber/DataReaderListener.hpp"
 #include "fastdds/dds/subscriber/SampleInfo.hpp"
 #include "fastdds/dds/subscriber/qos/DataReaderQos.hpp"
+#include "fastdds/dds/topic/ContentFilteredTopic.hpp"
 #include "fastdds/dds/topic/TypeSupport.hpp"
 
 #include "fastdds/rtps/common/Guid.h"
@@ -41,6 +41,8 @@
 
 #include "rmw/event_callback_type.h"
 
+#include "rmw_fastrtps_shared_cpp/event_callback_slot.hpp"
+#include "rmw_fastrtps_shared_cpp/ready_counter.hpp"
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 
 class ClientListener;
@@ -60,6 +62,8 @@ typedef struct CustomClientInfo
 
   eprosima::fastdds::dds::Topic * request_topic_{nullptr};
   eprosima::fastdds::dds::Topic * response_topic_{nullptr};
+  // Filters out the responses to other clients, see ResponseFilter
+  eprosima::fastdds::dds::ContentFilteredTopic * response_filtered_topic_{nullptr};
 
   ClientListener * listener_{nullptr};
   eprosima::fastrtps::rtps::GUID_t writer_guid_;
@@ -69,12 +73,12 @@ typedef struct CustomClientInfo
   ClientPubListener * pub_listener_{nullptr};
   std::atomic_size_t response_subscriber_matched_count_;
   std::atomic_size_t request_publisher_matched_count_;
+  rmw_fastrtps_shared_cpp::ReadyCounter ready_counter_;
 } CustomClientInfo;
 
 typedef struct CustomClientResponse
 {
   eprosima::fastrtps::rtps::SampleIdentity sample_identity_;
-  std::unique_ptr<eprosima::fastcdr::FastBuffer> buffer_;
 } CustomClientResponse;
 
 class ClientListener : public eprosima::fastdds::dds::DataReaderListener
@@ -90,15 +94,10 @@ public:
   on_data_available(
     eprosima::fastdds::dds::DataReader *)
   {
-    std::unique_lock<std::mutex> lock_mutex(on_new_response_m_);
+    info_->ready_counter_.notify();
 
-    if (on_new_response_cb_) {
-      auto unread_responses = get_unread_responses();
-
-      if (0 < unread_responses) {
-        on_new_response_cb_(user_data_, unread_responses);
-      }
-    }
+    // Fast DDS notifies each new response
+    on_new_response_slot_.call(1u);
   }
 
   void on_subscription_matched(
@@ -120,6 +119,7 @@ public:
 
   size_t get_unread_responses()
   {
+    // Marks the responses as read, so they are only reported once
     return info_->response_reader_->get_unread_count(true);
   }
 
@@ -130,30 +130,15 @@ public:
     const void * user_data,
     rmw_event_callback_t callback)
   {
+    on_new_response_slot_.set(callback, user_data);
+
     if (callback) {
+      // Report the responses received before the callback was set
       auto unread_responses = get_unread_responses();
 
-      std::lock_guard<std::mutex> lock_mutex(on_new_response_m_);
-
       if (0 < unread_responses) {
-        callback(user_data, unread_responses);
+        on_new_response_slot_.call(unread_responses);
       }
-
-      user_data_ = user_data;
-      on_new_response_cb_ = callback;
-
-      eprosima::fastdds::dds::StatusMask status_mask = info_->response_reader_->get_status_mask();
-      status_mask |= eprosima::fastdds::dds::StatusMask::data_available();
-      info_->response_reader_->set_listener(this, status_mask);
-    } else {
-      std::lock_guard<std::mutex> lock_mutex(on_new_response_m_);
-
-      eprosima::fastdds::dds::StatusMask status_mask = info_->response_reader_->get_status_mask();
-      status_mask &= ~eprosima::fastdds::dds::StatusMask::data_available();
-      info_->response_reader_->set_listener(this, status_mask);
-
-      user_data_ = nullptr;
-      on_new_response_cb_ = nullptr;
     }
   }
 
@@ -162,11 +147,7 @@ private:
 
   std::set<eprosima::fastrtps::rtps::GUID_t> publishers_;
 
-  rmw_event_callback_t on_new_response_cb_{nullptr};
-
-  const void * user_data_{nullptr};
-
-  std::mutex on_new_response_m_;
+  rmw_fastrtps_shared_cpp::EventCallbackSlot on_new_response_slot_;
 };
 
 class ClientPubListener : public eprosima::fastdds::dds::DataWriterListener
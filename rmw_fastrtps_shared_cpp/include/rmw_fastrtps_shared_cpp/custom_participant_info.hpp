@@ -15,6 +15,7 @@
 #ifndef RMW_FASTRTPS_SHARED_CPP__CUSTOM_PARTICIPANT_INFO_HPP_
 #define RMW_FASTRTPS_SHARED_CPP__CUSTOM_PARTICIPANT_INFO_HPP_
 
+#include <list>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -28,6 +29,7 @@
 #include "fastdds/dds/publisher/Publisher.hpp"
 #include "fastdds/dds/subscriber/Subscriber.hpp"
 
+#include "fastdds/rtps/flowcontrol/FlowControllerDescriptor.hpp"
 #include "fastdds/rtps/participant/ParticipantDiscoveryInfo.h"
 #include "fastdds/rtps/reader/ReaderDiscoveryInfo.h"
 #include "fastdds/rtps/writer/WriterDiscoveryInfo.h"
@@ -58,6 +60,31 @@ enum class publishing_mode_t
   AUTO           // Use publishing mode set in XML file or Fast DDS default
 };
 
+// DataWriters of the topics matching topic_pattern publish asynchronously through a flow
+// controller of the participant.
+struct FlowControlledTopic
+{
+  std::string topic_pattern;
+  const char * flow_controller_name;
+  // Priority of the DataWriters for the scheduler of the flow controller,
+  // from -10 (highest) to 10 (lowest)
+  int32_t priority;
+};
+
+// Flow controllers registered in a participant, taken from env "RMW_FASTRTPS_FLOW_CONTROLLERS",
+// and the topics using them, taken from env "RMW_FASTRTPS_FLOW_CONTROLLER_TOPICS".
+// It cannot be copied, as the descriptors and the topics refer to the names it holds.
+struct FlowControlSettings
+{
+  FlowControlSettings() = default;
+  FlowControlSettings(const FlowControlSettings &) = delete;
+  FlowControlSettings & operator=(const FlowControlSettings &) = delete;
+
+  std::list<std::string> names;
+  std::vector<std::shared_ptr<eprosima::fastdds::rtps::FlowControllerDescriptor>> controllers;
+  std::vector<FlowControlledTopic> topics;
+};
+
 class CustomTopicListener final : public eprosima::fastdds::dds::TopicListener
 {
 public:
@@ -117,6 +144,25 @@ typedef struct CustomParticipantInfo
   bool leave_middleware_default_qos;
   publishing_mode_t publishing_mode;
 
+  // Patterns of the topic names whose endpoints use data-sharing delivery,
+  // taken from env "RMW_FASTRTPS_DATA_SHARING_TOPICS".
+  std::vector<std::string> data_sharing_topics;
+
+  // Patterns of the topic names whose DataWriters lend their buffers to publishers,
+  // taken from env "RMW_FASTRTPS_BORROWED_PAYLOAD_TOPICS".
+  std::vector<std::string> borrowed_payload_topics;
+
+  // Number of messages preallocated by each publisher loaning messages from a pool,
+  // taken from env "RMW_FASTRTPS_LOANED_MESSAGE_POOL_SIZE".
+  size_t loaned_message_pool_size;
+
+  // Flow controllers of the participant, null when there are none.
+  std::unique_ptr<FlowControlSettings> flow_control;
+
+  // Whether ros_discovery_info is keyed on the participant gid,
+  // taken from env "RMW_FASTRTPS_KEYED_DISCOVERY_INFO".
+  bool keyed_discovery_info;
+
   RMW_FASTRTPS_SHARED_CPP_PUBLIC
   eprosima::fastdds::dds::Topic * find_or_create_topic(
     const std::string & topic_name,
@@ -15,6 +15,7 @@
 #ifndef RMW_FASTRTPS_SHARED_CPP__CUSTOM_PUBLISHER_INFO_HPP_
 #define RMW_FASTRTPS_SHARED_CPP__CUSTOM_PUBLISHER_INFO_HPP_
 
+#include <memory>
 #include <mutex>
 #include <set>
 
@@ -35,6 +36,8 @@
 #include "rmw/rmw.h"
 
 #include "rmw_fastrtps_shared_cpp/custom_event_info.hpp"
+#include "rmw_fastrtps_shared_cpp/loaned_message_pool.hpp"
+#include "rmw_fastrtps_shared_cpp/serialized_payload_pool.hpp"
 
 class RMWPublisherEvent;
 
@@ -86,6 +89,12 @@ typedef struct CustomPublisherInfo : public CustomEventInfo
 
   eprosima::fastdds::dds::Topic * topic_{nullptr};
 
+  // Only used by publishers of bounded types which are not plain, see LoanedMessagePool
+  std::unique_ptr<rmw_fastrtps_shared_cpp::LoanedMessagePool> loan_pool_;
+
+  // Payload pool of the DataWriter, only used when data-sharing is off
+  std::shared_ptr<rmw_fastrtps_shared_cpp::SerializedPayloadPool> payload_pool_;
+
   RMW_FASTRTPS_SHARED_CPP_PUBLIC
   EventListenerInterface *
   get_listener() const final;
@@ -15,10 +15,13 @@
 #ifndef RMW_FASTRTPS_SHARED_CPP__CUSTOM_SERVICE_INFO_HPP_
 #define RMW_FASTRTPS_SHARED_CPP__CUSTOM_SERVICE_INFO_HPP_
 
-#include <condition_variable>
+#include <atomic>
+#include <cstdint>
 #include <mutex>
 #include <unordered_set>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "fastcdr/FastBuffer.h"
 
@@ -35,12 +38,18 @@
 #include "fastdds/rtps/common/Guid.h"
 #include "fastdds/rtps/common/InstanceHandle.h"
 #include "fastdds/rtps/common/SampleIdentity.h"
+#include "fastdds/rtps/common/WriteParams.h"
 
 #include "rcpputils/thread_safety_annotations.hpp"
+#include "rcutils/logging_macros.h"
 
 #include "rmw/event_callback_type.h"
+#include "rmw/serialized_message.h"
 
 #include "rmw_fastrtps_shared_cpp/guid_utils.hpp"
+#include "rmw_fastrtps_shared_cpp/event_callback_slot.hpp"
+#include "rmw_fastrtps_shared_cpp/ready_counter.hpp"
+#include "rmw_fastrtps_shared_cpp/response_flusher.hpp"
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 
 class ServiceListener;
@@ -70,19 +79,22 @@ typedef struct CustomServiceInfo
   ServicePubListener * pub_listener_{nullptr};
 
   const char * typesupport_identifier_{nullptr};
+  rmw_fastrtps_shared_cpp::ReadyCounter ready_counter_;
 } CustomServiceInfo;
 
 typedef struct CustomServiceRequest
 {
   eprosima::fastrtps::rtps::SampleIdentity sample_identity_;
-  eprosima::fastcdr::FastBuffer * buffer_;
-
-  CustomServiceRequest()
-  : buffer_(nullptr)
-  {
-  }
 } CustomServiceRequest;
 
+// Response to a client whose response reader was not matched yet when it was sent
+struct DeferredResponse
+{
+  eprosima::fastrtps::rtps::WriteParams wparams;
+  // CDR serialized response, including the encapsulation
+  std::vector<uint8_t> payload;
+};
+
 class ServicePubListener : public eprosima::fastdds::dds::DataWriterListener
 {
   using subscriptions_set_t =
@@ -92,80 +104,159 @@ class ServicePubListener : public eprosima::fastdds::dds::DataWriterListener
     std::unordered_map<eprosima::fastrtps::rtps::GUID_t,
       eprosima::fastrtps::rtps::GUID_t,
       rmw_fastrtps_shared_cpp::hash_fastrtps_guid>;
+  using deferred_responses_map_t =
+    std::unordered_map<eprosima::fastrtps::rtps::GUID_t,
+      std::vector<DeferredResponse>,
+      rmw_fastrtps_shared_cpp::hash_fastrtps_guid>;
 
 public:
-  explicit ServicePubListener(
-    CustomServiceInfo * info)
+  // Maximum number of responses waiting for the response readers of their clients to match,
+  // or to be written once they are
+  static constexpr size_t max_deferred_responses = 256u;
+
+  ServicePubListener(
+    CustomServiceInfo * info,
+    rmw_fastrtps_shared_cpp::ResponseFlusher * flusher)
+  : flusher_(flusher)
   {
     (void) info;
   }
 
   void
   on_publication_matched(
-    eprosima::fastdds::dds::DataWriter * /* writer */,
+    eprosima::fastdds::dds::DataWriter * writer,
     const eprosima::fastdds::dds::PublicationMatchedStatus & info) final
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (info.current_count_change == 1) {
-      subscriptions_.insert(eprosima::fastrtps::rtps::iHandle2GUID(info.last_subscription_handle));
-    } else if (info.current_count_change == -1) {
-      eprosima::fastrtps::rtps::GUID_t erase_endpoint_guid =
+    bool flush_now = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      eprosima::fastrtps::rtps::GUID_t endpoint_guid =
         eprosima::fastrtps::rtps::iHandle2GUID(info.last_subscription_handle);
-      subscriptions_.erase(erase_endpoint_guid);
-      auto endpoint = clients_endpoints_.find(erase_endpoint_guid);
-      if (endpoint != clients_endpoints_.end()) {
-        clients_endpoints_.erase(endpoint->second);
-        clients_endpoints_.erase(erase_endpoint_guid);
+      if (info.current_count_change == 1) {
+        subscriptions_.insert(endpoint_guid);
+        auto deferred = deferred_responses_.find(endpoint_guid);
+        if (deferred != deferred_responses_.end()) {
+          // Not written from the discovery thread, but by the listener thread of the context
+          for (DeferredResponse & response : deferred->second) {
+            sendable_responses_.push_back(std::move(response));
+          }
+          deferred_responses_.erase(deferred);
+          has_sendable_responses_.store(true);
+          flush_now = flusher_ && !flusher_->schedule(this, writer);
+        }
+      } else if (info.current_count_change == -1) {
+        subscriptions_.erase(endpoint_guid);
+        erase_endpoint(endpoint_guid);
       }
-    } else {
-      return;
     }
-    cv_.notify_all();
+    if (flush_now) {
+      flush_responses(writer);
+    }
   }
 
-  template<class Rep, class Period>
-  bool
-  wait_for_subscription(
-    const eprosima::fastrtps::rtps::GUID_t & guid,
-    const std::chrono::duration<Rep, Period> & rel_time)
+  // Stop scheduling the parked responses, before the service is destroyed
+  void
+  detach_flusher()
   {
-    auto guid_is_present = [this, guid]() RCPPUTILS_TSA_REQUIRES(mutex_)->bool
+    rmw_fastrtps_shared_cpp::ResponseFlusher * flusher = nullptr;
     {
-      return subscriptions_.find(guid) != subscriptions_.end();
-    };
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::swap(flusher, flusher_);
+    }
+    if (flusher) {
+      flusher->remove(this);
+    }
+  }
+
+  // Write the parked responses whose clients have been matched since the last call.
+  // Called from the listener thread of the context and from __rmw_send_response, so the
+  // discovery thread does not write them.
+  void
+  flush_responses(eprosima::fastdds::dds::DataWriter * writer)
+  {
+    if (!has_sendable_responses_.load()) {
+      return;
+    }
+
+    // Only cleared once the responses are written, so responses written after a concurrent
+    // flush wait for it, and clients get their responses in order
+    std::lock_guard<std::mutex> flush_lock(flush_mutex_);
+    while (true) {
+      std::vector<DeferredResponse> responses;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (sendable_responses_.empty()) {
+          has_sendable_responses_.store(false);
+          return;
+        }
+        responses.swap(sendable_responses_);
+        deferred_count_ -= responses.size();
+      }
 
-    std::unique_lock<std::mutex> lock(mutex_);
-    return cv_.wait_for(lock, rel_time, guid_is_present);
+      // Sent without holding the lock, as writing may call back into this listener
+      for (DeferredResponse & response : responses) {
+        rmw_serialized_message_t message = rmw_get_zero_initialized_serialized_message();
+        message.buffer = response.payload.data();
+        message.buffer_length = response.payload.size();
+        message.buffer_capacity = response.payload.size();
+
+        rmw_fastrtps_shared_cpp::SerializedData data;
+        data.type = rmw_fastrtps_shared_cpp::FASTRTPS_SERIALIZED_DATA_TYPE_SERIALIZED_MESSAGE;
+        data.data = &message;
+        data.impl = nullptr;
+        if (!writer->write(&data, response.wparams)) {
+          RCUTILS_LOG_WARN_NAMED(
+            "rmw_fastrtps_shared_cpp", "cannot publish deferred service response");
+        }
+      }
+    }
   }
 
   client_present_t
   check_for_subscription(
     const eprosima::fastrtps::rtps::GUID_t & guid)
   {
-    {
-      std::lock_guard<std::mutex> lock(mutex_);
-      // Check if the guid is still in the map
-      if (clients_endpoints_.find(guid) == clients_endpoints_.end()) {
-        // Client is gone
-        return client_present_t::GONE;
-      }
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Check if the guid is still in the map
+    if (clients_endpoints_.find(guid) == clients_endpoints_.end()) {
+      // Client is gone
+      return client_present_t::GONE;
     }
-    // Wait for subscription
-    if (!wait_for_subscription(guid, std::chrono::milliseconds(100))) {
+    if (subscriptions_.find(guid) == subscriptions_.end()) {
       return client_present_t::MAYBE;
     }
     return client_present_t::YES;
   }
 
+  // Keep a response until the response reader with the given guid is matched.
+  // Returns MAYBE if the response was kept, YES if the reader has been matched in the meantime,
+  // so the response can be written right away, GONE if the client is gone, and FAILURE if too
+  // many responses are already waiting.
+  client_present_t
+  defer_response(
+    const eprosima::fastrtps::rtps::GUID_t & guid,
+    DeferredResponse && response)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (clients_endpoints_.find(guid) == clients_endpoints_.end()) {
+      return client_present_t::GONE;
+    }
+    if (subscriptions_.find(guid) != subscriptions_.end()) {
+      return client_present_t::YES;
+    }
+    if (deferred_count_ >= max_deferred_responses) {
+      return client_present_t::FAILURE;
+    }
+    deferred_responses_[guid].push_back(std::move(response));
+    ++deferred_count_;
+    return client_present_t::MAYBE;
+  }
+
   void endpoint_erase_if_exists(
     const eprosima::fastrtps::rtps::GUID_t & endpointGuid)
   {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto endpoint = clients_endpoints_.find(endpointGuid);
-    if (endpoint != clients_endpoints_.end()) {
-      clients_endpoints_.erase(endpoint->second);
-      clients_endpoints_.erase(endpointGuid);
-    }
+    erase_endpoint(endpointGuid);
   }
 
   void endpoint_add_reader_and_writer(
@@ -178,10 +269,41 @@ public:
   }
 
 private:
+  // Forget a client, given the guid of its request writer or response reader,
+  // dropping the responses waiting for it
+  void erase_endpoint(
+    const eprosima::fastrtps::rtps::GUID_t & endpointGuid) RCPPUTILS_TSA_REQUIRES(mutex_)
+  {
+    auto endpoint = clients_endpoints_.find(endpointGuid);
+    if (endpoint != clients_endpoints_.end()) {
+      drop_deferred_responses(endpoint->second);
+      drop_deferred_responses(endpointGuid);
+      clients_endpoints_.erase(endpoint->second);
+      clients_endpoints_.erase(endpointGuid);
+    }
+  }
+
+  void drop_deferred_responses(
+    const eprosima::fastrtps::rtps::GUID_t & readerGuid) RCPPUTILS_TSA_REQUIRES(mutex_)
+  {
+    auto deferred = deferred_responses_.find(readerGuid);
+    if (deferred != deferred_responses_.end()) {
+      deferred_count_ -= deferred->second.size();
+      deferred_responses_.erase(deferred);
+    }
+  }
+
   std::mutex mutex_;
   subscriptions_set_t subscriptions_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
   clients_endpoints_map_t clients_endpoints_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
-  std::condition_variable cv_;
+  deferred_responses_map_t deferred_responses_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+  // Responses whose clients have been matched, waiting for flush_responses()
+  std::vector<DeferredResponse> sendable_responses_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+  // Number of responses either deferred or sendable
+  size_t deferred_count_ RCPPUTILS_TSA_GUARDED_BY(mutex_) {0};
+  rmw_fastrtps_shared_cpp::ResponseFlusher * flusher_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+  std::atomic<bool> has_sendable_responses_{false};
+  std::mutex flush_mutex_;
 };
 
 class ServiceListener : public eprosima::fastdds::dds::DataReaderListener
@@ -206,6 +328,7 @@ public:
 
   size_t get_unread_resquests()
   {
+    // Marks the requests as read, so they are only reported once
     return info_->request_reader_->get_unread_count(true);
   }
 
@@ -213,13 +336,10 @@ public:
   on_data_available(
     eprosima::fastdds::dds::DataReader *) final
   {
-    std::unique_lock<std::mutex> lock_mutex(on_new_request_m_);
+    info_->ready_counter_.notify();
 
-    auto unread_requests = get_unread_resquests();
-
-    if (0u < unread_requests) {
-      on_new_request_cb_(user_data_, unread_requests);
-    }
+    // Fast DDS notifies each new request
+    on_new_request_slot_.call(1u);
   }
 
   // Provide handlers to perform an action when a
@@ -229,41 +349,22 @@ public:
     const void * user_data,
     rmw_event_callback_t callback)
   {
+    on_new_request_slot_.set(callback, user_data);
+
     if (callback) {
+      // Report the requests received before the callback was set
       auto unread_requests = get_unread_resquests();
 
-      std::lock_guard<std::mutex> lock_mutex(on_new_request_m_);
-
       if (0 < unread_requests) {
-        callback(user_data, unread_requests);
+        on_new_request_slot_.call(unread_requests);
       }
-
-      user_data_ = user_data;
-      on_new_request_cb_ = callback;
-
-      eprosima::fastdds::dds::StatusMask status_mask = info_->request_reader_->get_status_mask();
-      status_mask |= eprosima::fastdds::dds::StatusMask::data_available();
-      info_->request_reader_->set_listener(this, status_mask);
-    } else {
-      std::lock_guard<std::mutex> lock_mutex(on_new_request_m_);
-
-      eprosima::fastdds::dds::StatusMask status_mask = info_->request_reader_->get_status_mask();
-      status_mask &= ~eprosima::fastdds::dds::StatusMask::data_available();
-      info_->request_reader_->set_listener(this, status_mask);
-
-      user_data_ = nullptr;
-      on_new_request_cb_ = nullptr;
     }
   }
 
 private:
   CustomServiceInfo * info_;
 
-  rmw_event_callback_t on_new_request_cb_{nullptr};
-
-  const void * user_data_{nullptr};
-
-  std::mutex on_new_request_m_;
+  rmw_fastrtps_shared_cpp::EventCallbackSlot on_new_request_slot_;
 };
 
 #endif  // RMW_FASTRTPS_SHARED_CPP__CUSTOM_SERVICE_INFO_HPP_
@@ -43,6 +43,8 @@
 #include "rmw_dds_common/context.hpp"
 
 #include "rmw_fastrtps_shared_cpp/custom_event_info.hpp"
+#include "rmw_fastrtps_shared_cpp/event_callback_slot.hpp"
+#include "rmw_fastrtps_shared_cpp/ready_counter.hpp"
 
 class RMWSubscriptionEvent;
 
@@ -102,6 +104,10 @@ struct CustomSubscriberInfo : public CustomEventInfo
   rmw_gid_t subscription_gid_{};
   const char * typesupport_identifier_{nullptr};
   std::shared_ptr<rmw_fastrtps_shared_cpp::LoanManager> loan_manager_;
+  rmw_fastrtps_shared_cpp::ReadyCounter ready_counter_;
+  // Keeps the sample inspected by a take ignoring local publications from being taken by
+  // another one before it
+  std::mutex ignore_local_take_mutex_;
 
   // for re-create or delete content filtered topic
   const rmw_node_t * node_ {nullptr};
@@ -193,6 +199,14 @@ public:
   RMW_FASTRTPS_SHARED_CPP_PUBLIC
   size_t publisher_count() const;
 
+  /// Return whether a publisher is matched to this subscription.
+  /**
+   * \param[in] guid The GUID of the publisher.
+   * \return true if the publisher is in the internal set of matched publishers.
+   */
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  bool is_publisher_tracked(const eprosima::fastrtps::rtps::GUID_t & guid) const;
+
   RMW_FASTRTPS_SHARED_CPP_PUBLIC
   void update_data_available();
 
@@ -255,11 +269,7 @@ private:
   std::set<eprosima::fastrtps::rtps::GUID_t> publishers_ RCPPUTILS_TSA_GUARDED_BY(
     publishers_mutex_);
 
-  rmw_event_callback_t on_new_message_cb_{nullptr};
-
-  const void * new_message_user_data_{nullptr};
-
-  std::mutex on_new_message_m_;
+  rmw_fastrtps_shared_cpp::EventCallbackSlot on_new_message_slot_;
 
   mutable std::mutex publishers_mutex_;
 
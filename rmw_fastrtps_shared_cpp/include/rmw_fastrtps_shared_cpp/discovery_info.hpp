@@ -0,0 +1,44 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__DISCOVERY_INFO_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__DISCOVERY_INFO_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "rmw_dds_common/msg/participant_entities_info.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Type of the key of ros_discovery_info, when keyed: the gid of the participant.
+/**
+ * The gid is the first member of ParticipantEntitiesInfo, so its serialization comes right
+ * after the encapsulation.
+ */
+using DiscoveryInfoKey = rmw_dds_common::msg::ParticipantEntitiesInfo::_gid_type::_data_type;
+
+static_assert(
+  std::is_same<DiscoveryInfoKey::value_type, uint8_t>::value,
+  "the key of ros_discovery_info must be serialized the same way on both endiannesses");
+
+/// Serialized size of the key of ros_discovery_info, when keyed.
+constexpr size_t discovery_info_key_size = std::tuple_size<DiscoveryInfoKey>::value;
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__DISCOVERY_INFO_HPP_
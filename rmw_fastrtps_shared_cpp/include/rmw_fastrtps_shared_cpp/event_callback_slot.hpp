@@ -0,0 +1,160 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__EVENT_CALLBACK_SLOT_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__EVENT_CALLBACK_SLOT_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "rmw/event_callback_type.h"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Holds a user callback called from the Fast DDS listener threads.
+/**
+ * call() never blocks: it announces itself in the reader count of the current epoch, loads the
+ * current callback through an atomic pointer, and calls it.
+ *
+ * set() swaps the pointer, then flips the epoch twice, each time waiting for the readers of the
+ * epoch it left, so once it returns the previous callback won't be called anymore and is freed.
+ * set() can be called from inside a callback of the same slot, in which case it does not wait,
+ * and the previous callback is freed by the next set() made from outside.
+ */
+class EventCallbackSlot
+{
+public:
+  EventCallbackSlot() = default;
+
+  EventCallbackSlot(const EventCallbackSlot &) = delete;
+  EventCallbackSlot & operator=(const EventCallbackSlot &) = delete;
+
+  ~EventCallbackSlot()
+  {
+    set(nullptr, nullptr);
+  }
+
+  /// Replace the current callback; a null callback clears it.
+  void
+  set(rmw_event_callback_t callback, const void * user_data)
+  {
+    Entry * entry = nullptr;
+    if (callback) {
+      entry = new Entry{callback, user_data};
+    }
+    Entry * previous = current_.exchange(entry);
+
+    if (is_calling()) {
+      // Waiting would wait for the running callback, which is this one
+      if (previous) {
+        std::lock_guard<std::mutex> lock(retired_mutex_);
+        retired_.push_back(previous);
+      }
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(set_mutex_);
+    // Entries retired so far were replaced before the readers are waited for
+    std::vector<Entry *> retired;
+    {
+      std::lock_guard<std::mutex> retired_lock(retired_mutex_);
+      retired.swap(retired_);
+    }
+    retired.push_back(previous);
+
+    // A reader which loaded a retired entry is counted in one of both epochs until it is done
+    for (int flip = 0; flip < 2; ++flip) {
+      const uint32_t left_epoch = epoch_.fetch_add(1u);
+      while (0u != active_[left_epoch & 1u].load()) {
+        std::this_thread::yield();
+      }
+    }
+
+    for (Entry * retired_entry : retired) {
+      delete retired_entry;
+    }
+  }
+
+  /// Call the current callback, if any, with the given count.
+  /**
+   * \return true if a callback was called.
+   */
+  bool
+  call(size_t count)
+  {
+    std::atomic<uint32_t> & active = active_[epoch_.load() & 1u];
+    ++active;
+    Entry * entry = current_.load();
+    if (entry) {
+      Frame frame{this, calling_frames()};
+      calling_frames() = &frame;
+      entry->callback(entry->user_data, count);
+      calling_frames() = frame.previous;
+    }
+    --active;
+    return nullptr != entry;
+  }
+
+private:
+  struct Entry
+  {
+    const rmw_event_callback_t callback;
+    const void * const user_data;
+  };
+
+  // Slots whose callback is being called by this thread, innermost first
+  struct Frame
+  {
+    const EventCallbackSlot * slot;
+    Frame * previous;
+  };
+
+  static Frame * &
+  calling_frames()
+  {
+    thread_local Frame * top = nullptr;
+    return top;
+  }
+
+  bool
+  is_calling() const
+  {
+    for (Frame * frame = calling_frames(); frame; frame = frame->previous) {
+      if (this == frame->slot) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  std::atomic<Entry *> current_{nullptr};
+  std::atomic<uint32_t> epoch_{0u};
+  // Number of running calls, by parity of the epoch they started in
+  std::atomic<uint32_t> active_[2] = {{0u}, {0u}};
+
+  // Serializes the epoch flips of concurrent set() calls
+  std::mutex set_mutex_;
+  // Entries replaced from inside a callback, waiting to be freed
+  std::mutex retired_mutex_;
+  std::vector<Entry *> retired_;
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__EVENT_CALLBACK_SLOT_HPP_
@@ -0,0 +1,90 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__GRAPH_CHANGE_NOTIFIER_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__GRAPH_CHANGE_NOTIFIER_HPP_
+
+#include <chrono>
+#include <memory>
+
+#include "rmw_dds_common/context.hpp"
+
+#include "rmw_fastrtps_shared_cpp/coalesced_action.hpp"
+#include "rmw_fastrtps_shared_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Coalesces the changes of the graph cache of a context into graph guard condition triggers.
+/**
+ * The graph guard condition is triggered right away on a change if it was not triggered during
+ * the last period.
+ * Otherwise the listener thread triggers it once at the end of the period, for all the changes
+ * which happened in the meantime, so no change is notified later than one period after it
+ * happened.
+ *
+ * The period is read from the environment variable RMW_FASTRTPS_GRAPH_CHANGE_PERIOD, in
+ * milliseconds, and 0 triggers the graph guard condition on every change.
+ */
+class GraphChangeNotifier
+{
+public:
+  /// Period used when RMW_FASTRTPS_GRAPH_CHANGE_PERIOD is not set.
+  static constexpr std::chrono::milliseconds default_period{10};
+
+  /// Create a notifier with the period configured in the environment.
+  /**
+   * \return nullptr, with the error set, if the environment can not be read.
+   */
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  static std::unique_ptr<GraphChangeNotifier>
+  create(const char * identifier, rmw_dds_common::Context * common_context);
+
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  GraphChangeNotifier(
+    const char * identifier,
+    rmw_dds_common::Context * common_context,
+    std::chrono::milliseconds period);
+
+  /// Notify a change of the graph cache.
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  void
+  notify();
+
+  /// Trigger the graph guard condition for the pending changes, if any, once the period elapsed.
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  void
+  notify_pending();
+
+  /// Trigger the graph guard condition for the pending changes, if any, right away.
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  void
+  flush();
+
+  /// Time at which the pending changes have to be notified.
+  /**
+   * \return false if there are no pending changes.
+   */
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  bool
+  get_pending_deadline(std::chrono::steady_clock::time_point & deadline);
+
+private:
+  rmw_fastrtps_shared_cpp::CoalescedAction trigger_;
+  rmw_dds_common::Context * common_context_;
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__GRAPH_CHANGE_NOTIFIER_HPP_
@@ -0,0 +1,96 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__GRAPH_UPDATE_PUBLISHER_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__GRAPH_UPDATE_PUBLISHER_HPP_
+
+#include <chrono>
+#include <mutex>
+
+#include "rcpputils/thread_safety_annotations.hpp"
+
+#include "rmw/ret_types.h"
+
+#include "rmw_dds_common/context.hpp"
+#include "rmw_dds_common/msg/participant_entities_info.hpp"
+
+#include "rmw_fastrtps_shared_cpp/coalesced_action.hpp"
+#include "rmw_fastrtps_shared_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Publisher of the ParticipantEntitiesInfo updates of a context on ros_discovery_info.
+/**
+ * Every update is a complete snapshot of the participant, which supersedes the previous ones.
+ * Creating or destroying many entities in a row would otherwise publish one snapshot per entity,
+ * each of them growing with the number of entities.
+ * Instead, an update is published right away only if no other one was published during the last
+ * period, and later updates are coalesced into a single snapshot which the listener thread
+ * publishes when the period has elapsed.
+ */
+class GraphUpdatePublisher
+{
+public:
+  using ParticipantEntitiesInfo = rmw_dds_common::msg::ParticipantEntitiesInfo;
+
+  /// Minimum interval between two published updates.
+  static constexpr std::chrono::milliseconds period{50};
+
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  GraphUpdatePublisher(const char * identifier, rmw_dds_common::Context * common_context);
+
+  /// Publish an update, or keep it pending until the end of the current period.
+  /**
+   * Updates must be handed over in the order in which they were generated, i.e. with the
+   * node update mutex of the common context held.
+   */
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  rmw_ret_t
+  publish(const ParticipantEntitiesInfo & msg);
+
+  /// Publish the pending update, if any, once its period has elapsed.
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  rmw_ret_t
+  publish_pending();
+
+  /// Publish the pending update, if any, right away.
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  rmw_ret_t
+  flush();
+
+  /// Time at which the pending update has to be published.
+  /**
+   * \return false if there is no pending update.
+   */
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  bool
+  get_pending_deadline(std::chrono::steady_clock::time_point & deadline);
+
+private:
+  rmw_ret_t
+  publish_latest();
+
+  const char * identifier_;
+  rmw_dds_common::Context * common_context_;
+
+  std::mutex update_mutex_;
+  ParticipantEntitiesInfo latest_update_ RCPPUTILS_TSA_GUARDED_BY(update_mutex_);
+
+  rmw_fastrtps_shared_cpp::CoalescedAction publication_;
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__GRAPH_UPDATE_PUBLISHER_HPP_
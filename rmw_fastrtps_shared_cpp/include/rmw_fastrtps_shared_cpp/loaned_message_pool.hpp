@@ -0,0 +1,113 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__LOANED_MESSAGE_POOL_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__LOANED_MESSAGE_POOL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include "rcpputils/thread_safety_annotations.hpp"
+
+#include "rosidl_runtime_c/message_type_support_struct.h"
+
+#include "rmw_fastrtps_shared_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Pool of preallocated ROS messages loaned by publishers of bounded, non-plain types.
+/**
+ * Fast DDS can only loan samples of plain types, which are directly written into the payload
+ * pool of the DataWriter.
+ * For bounded types the publisher hands out messages from this pool instead, and serializes them
+ * straight into the payload pool of the DataWriter when they are published.
+ *
+ * Messages are constructed once, when the pool is created, and are not cleared when they are
+ * returned, so strings and sequences keep the capacity of previous loans and reusing them does
+ * not allocate.
+ * Once all of them are loaned, messages are allocated on demand and destroyed when returned.
+ */
+class LoanedMessagePool
+{
+public:
+  /// Number of preallocated messages of each publisher, unless configured otherwise.
+  /**
+   * See env "RMW_FASTRTPS_LOANED_MESSAGE_POOL_SIZE".
+   */
+  static constexpr size_t default_pool_size = 8u;
+
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  ~LoanedMessagePool();
+
+  /// Create a pool for the introspection type support found in type_supports.
+  /**
+   * \return nullptr if no introspection type support is available, or on allocation failure.
+   */
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  static std::unique_ptr<LoanedMessagePool>
+  create(const rosidl_message_type_support_t * type_supports, size_t pool_size);
+
+  /// Take a message out of the pool.
+  /**
+   * When all the preallocated messages are loaned, a new one is allocated.
+   *
+   * \return nullptr on allocation failure.
+   */
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  void *
+  borrow();
+
+  /// Give a loaned message back to the pool.
+  /**
+   * \return false if the message was not loaned by this pool, or was already given back.
+   */
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  bool
+  release(void * message);
+
+private:
+  using FiniFunction = void (*)(void *);
+
+  LoanedMessagePool() = default;
+
+  void *
+  allocate_message();
+
+  void
+  free_message(void * message);
+
+  std::unique_ptr<std::max_align_t[]> arena_;
+  size_t stride_{0};
+  size_t pool_size_{0};
+  size_t initialized_{0};
+  std::function<void(void *)> init_function_;
+  FiniFunction fini_function_{nullptr};
+
+  std::mutex mutex_;
+  std::vector<uint8_t *> free_messages_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+  // Whether each message of the arena is loaned, indexed by its position in the arena
+  std::vector<bool> loaned_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+  // Messages allocated because the arena was exhausted, still loaned
+  std::unordered_set<void *> overflow_messages_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__LOANED_MESSAGE_POOL_HPP_
@@ -0,0 +1,105 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__NAMES_AND_TYPES_CACHE_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__NAMES_AND_TYPES_CACHE_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "rcpputils/thread_safety_annotations.hpp"
+
+#include "rcutils/allocator.h"
+
+#include "rmw/names_and_types.h"
+#include "rmw/ret_types.h"
+
+#include "rmw_fastrtps_shared_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Snapshots of the names and types queried from the graph cache of a context.
+/**
+ * Every change of the graph cache increments the generation of this cache.
+ * A query is only run against the graph cache when its snapshot is from an older generation,
+ * otherwise the demangled names and types of the snapshot are copied to the caller.
+ */
+class NamesAndTypesCache
+{
+public:
+  /// Fill names_and_types with the given allocator.
+  using QueryFunction =
+    std::function<rmw_ret_t(rcutils_allocator_t * allocator, rmw_names_and_types_t *)>;
+
+  /// Number of snapshots kept, before all of them are dropped to make room for new ones.
+  static constexpr size_t max_snapshots = 256u;
+
+  /// Invalidate all snapshots, to be called on every change of the graph.
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  void
+  invalidate();
+
+  /// Current generation of the graph.
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  uint64_t
+  generation() const;
+
+  /// Get the result of a query, from its snapshot when the graph did not change since.
+  /**
+   * \param[in] key identifies the query, including all its arguments.
+   * \param[in] query fills names and types, only run when there is no valid snapshot.
+   * \param[in] allocator used for names_and_types.
+   * \param[out] names_and_types zero initialized names and types to fill.
+   * \return RMW_RET_OK, or the error of the query, or RMW_RET_BAD_ALLOC.
+   */
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  rmw_ret_t
+  get(
+    const std::string & key,
+    const QueryFunction & query,
+    rcutils_allocator_t * allocator,
+    rmw_names_and_types_t * names_and_types);
+
+private:
+  using Entries = std::vector<std::pair<std::string, std::vector<std::string>>>;
+
+  struct Snapshot
+  {
+    uint64_t generation;
+    std::shared_ptr<const Entries> entries;
+  };
+
+  static rmw_ret_t
+  copy_entries(
+    const Entries & entries,
+    rcutils_allocator_t * allocator,
+    rmw_names_and_types_t * names_and_types);
+
+  std::atomic<uint64_t> generation_{0u};
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, Snapshot> snapshots_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__NAMES_AND_TYPES_CACHE_HPP_
@@ -0,0 +1,97 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__READY_COUNTER_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__READY_COUNTER_HPP_
+
+#include <atomic>
+#include <cstdint>
+
+#include "fastdds/dds/core/LoanableCollection.hpp"
+#include "fastdds/dds/subscriber/DataReader.hpp"
+#include "fastdds/dds/subscriber/SampleInfo.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Tells whether a DataReader may have samples waiting to be taken.
+/**
+ * This lets rmw_wait know if a subscription, client or service is ready without accessing the
+ * history of its DataReader.
+ * For that, the DataReaderListener of the entity always keeps data_available enabled, and
+ * calls notify() on every notification, without querying the DataReader.
+ *
+ * Fast DDS may notify several samples at once, so notifications are not counted as samples.
+ * Instead, the notifications received before a take that drains the history, i.e. returns less
+ * samples than requested, are settled by that take.
+ * The entity is ready while some notifications are not settled, so it may be reported ready
+ * once more after its last sample has been taken, until a take finds no more samples, but it
+ * is never reported idle while samples are waiting.
+ */
+class ReadyCounter
+{
+public:
+  /// Record a data_available notification of the DataReader.
+  void
+  notify()
+  {
+    notified_.fetch_add(1u);
+  }
+
+  /// Whether there may be samples waiting to be taken.
+  bool
+  is_ready() const
+  {
+    return settled_.load() != notified_.load();
+  }
+
+  /// Take samples from a DataReader, keeping this counter up to date.
+  /**
+   * Has the same semantics as DataReader::take.
+   */
+  ReturnCode_t
+  take(
+    eprosima::fastdds::dds::DataReader * reader,
+    eprosima::fastdds::dds::LoanableCollection & data_values,
+    eprosima::fastdds::dds::SampleInfoSeq & sample_infos,
+    int32_t max_samples)
+  {
+    // Notifications received from now on may be for samples this take does not get
+    uint64_t notified = notified_.load();
+    ReturnCode_t ret = reader->take(data_values, sample_infos, max_samples);
+    if (ReturnCode_t::RETCODE_NO_DATA == ret ||
+      (ReturnCode_t::RETCODE_OK == ret && sample_infos.length() < max_samples))
+    {
+      settle(notified);
+    }
+    return ret;
+  }
+
+private:
+  void
+  settle(uint64_t notified)
+  {
+    // Concurrent takes may settle in any order, never go back
+    uint64_t settled = settled_.load();
+    while (settled < notified && !settled_.compare_exchange_weak(settled, notified)) {
+    }
+  }
+
+  std::atomic<uint64_t> notified_{0u};
+  std::atomic<uint64_t> settled_{0u};
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__READY_COUNTER_HPP_
@@ -0,0 +1,87 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__RESPONSE_FILTER_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__RESPONSE_FILTER_HPP_
+
+#include "fastdds/dds/topic/IContentFilter.hpp"
+#include "fastdds/dds/topic/IContentFilterFactory.hpp"
+#include "fastdds/dds/topic/TopicDataType.hpp"
+#include "fastrtps/types/TypesBase.h"
+
+#include "rmw_fastrtps_shared_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Content filter which routes the responses of a service to the client that sent the request.
+/**
+ * All the clients of a service read from the same response topic.
+ * Clients set the related sample identity of their requests to the GUID of their response
+ * reader, and servers copy it to the related sample identity of the responses, so a response is
+ * only relevant to the reader whose GUID it carries.
+ *
+ * The filter is stateless: the GUID of the reader a sample is evaluated for is given by Fast DDS,
+ * so a single instance serves every client.
+ * When the response writer belongs to a participant where the filter is registered, responses
+ * are filtered before being sent, otherwise they are filtered by the reader on reception.
+ * Responses related to a request writer GUID, which other implementations may send, are not
+ * filtered here, and are checked when the response is taken.
+ */
+class ResponseFilter final
+  : public eprosima::fastdds::dds::IContentFilterFactory,
+  public eprosima::fastdds::dds::IContentFilter
+{
+public:
+  /// Name the filter class is registered with on participants.
+  static constexpr const char * class_name = "RMW_FASTRTPS_RESPONSE_FILTER";
+
+  /// Expression of the content filtered topics of response readers.
+  /**
+   * The expression is not parsed, but it must not be empty, as Fast DDS does not filter samples
+   * of content filtered topics with an empty expression.
+   */
+  static constexpr const char * expression = "related_sample_identity";
+
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  static ResponseFilter &
+  get_instance();
+
+  eprosima::fastrtps::types::ReturnCode_t
+  create_content_filter(
+    const char * filter_class_name,
+    const char * type_name,
+    const eprosima::fastdds::dds::TopicDataType * data_type,
+    const char * filter_expression,
+    const ParameterSeq & filter_parameters,
+    eprosima::fastdds::dds::IContentFilter * & filter_instance) override;
+
+  eprosima::fastrtps::types::ReturnCode_t
+  delete_content_filter(
+    const char * filter_class_name,
+    eprosima::fastdds::dds::IContentFilter * filter_instance) override;
+
+  bool
+  evaluate(
+    const SerializedPayload & payload,
+    const FilterSampleInfo & sample_info,
+    const GUID_t & reader_guid) const override;
+
+private:
+  ResponseFilter() = default;
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__RESPONSE_FILTER_HPP_
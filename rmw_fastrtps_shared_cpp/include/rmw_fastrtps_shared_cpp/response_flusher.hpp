@@ -0,0 +1,79 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__RESPONSE_FLUSHER_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__RESPONSE_FLUSHER_HPP_
+
+#include <mutex>
+#include <unordered_map>
+
+#include "fastdds/dds/publisher/DataWriter.hpp"
+
+#include "rcpputils/thread_safety_annotations.hpp"
+
+#include "rmw_dds_common/context.hpp"
+
+#include "rmw_fastrtps_shared_cpp/visibility_control.h"
+
+class ServicePubListener;
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Writes the service responses parked until the response readers of their clients matched.
+/**
+ * Matches are notified from the Fast DDS discovery thread, which must not block writing, and
+ * executors do not necessarily call rmw_wait, so the listener thread of the context writes the
+ * parked responses of all its services.
+ * Without the listener thread, they are written right away.
+ */
+class ResponseFlusher
+{
+public:
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  ResponseFlusher(const char * identifier, rmw_dds_common::Context * common_context);
+
+  /// Have the listener thread write the parked responses of a service.
+  /**
+   * \return false if the listener thread is not running, in which case the caller must write
+   *   them.
+   */
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  bool
+  schedule(ServicePubListener * listener, eprosima::fastdds::dds::DataWriter * writer);
+
+  /// Write the parked responses of the services scheduled so far.
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  void
+  flush();
+
+  /// Forget a service, waiting for its responses to be written if they are being written.
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  void
+  remove(ServicePubListener * listener);
+
+private:
+  const char * identifier_;
+  rmw_dds_common::Context * common_context_;
+
+  // Held while writing, so remove() can wait for it
+  std::mutex flush_mutex_;
+  std::mutex mutex_;
+  std::unordered_map<ServicePubListener *, eprosima::fastdds::dds::DataWriter *> scheduled_
+  RCPPUTILS_TSA_GUARDED_BY(mutex_);
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__RESPONSE_FLUSHER_HPP_
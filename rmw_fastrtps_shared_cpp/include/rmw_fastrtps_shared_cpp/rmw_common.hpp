@@ -175,6 +175,45 @@ __rmw_publish_loaned_message(
   const void * ros_message,
   rmw_publisher_allocation_t * allocation);
 
+/// Borrow a buffer of the payload pool of a publisher, to write a serialized message into.
+/**
+ * On success, serialized_message refers to a buffer of at least size bytes, where the CDR
+ * serialized message, including its encapsulation header, has to be written.
+ * Its allocator is zero initialized, as the buffer cannot be resized.
+ * The buffer must be given to either __rmw_publish_borrowed_serialized_payload() or
+ * __rmw_return_borrowed_serialized_payload().
+ *
+ * \return RMW_RET_UNSUPPORTED if the publisher uses data-sharing.
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_borrow_serialized_payload(
+  const char * identifier,
+  const rmw_publisher_t * publisher,
+  size_t size,
+  rmw_serialized_message_t * serialized_message);
+
+/// Give back a borrowed buffer without publishing it.
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_return_borrowed_serialized_payload(
+  const char * identifier,
+  const rmw_publisher_t * publisher,
+  rmw_serialized_message_t * serialized_message);
+
+/// Publish the first buffer_length bytes of a borrowed buffer, without copying them.
+/**
+ * The buffer goes back to the publisher whatever the result, and serialized_message is zero
+ * initialized.
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_publish_borrowed_serialized_payload(
+  const char * identifier,
+  const rmw_publisher_t * publisher,
+  rmw_serialized_message_t * serialized_message,
+  rmw_publisher_allocation_t * allocation);
+
 RMW_FASTRTPS_SHARED_CPP_PUBLIC
 rmw_ret_t
 __rmw_publisher_assert_liveliness(
@@ -399,6 +438,33 @@ __rmw_return_loaned_message_from_subscription(
   const rmw_subscription_t * subscription,
   void * loaned_message);
 
+/// Loan up to count messages from the DataReader of a subscription with a single take.
+/**
+ * The loaned messages are stored in the first taken elements of message_sequence, and their
+ * info in message_info_sequence, which can be null.
+ * They are a single loan, given back all at once with __rmw_return_loaned_message_sequence().
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_take_loaned_message_sequence(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  size_t count,
+  rmw_message_sequence_t * message_sequence,
+  rmw_message_info_sequence_t * message_info_sequence,
+  size_t * taken);
+
+/// Give back the messages loaned by __rmw_take_loaned_message_sequence().
+/**
+ * On success, the size of message_sequence is set to 0.
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_return_loaned_message_sequence(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  rmw_message_sequence_t * message_sequence);
+
 RMW_FASTRTPS_SHARED_CPP_PUBLIC
 rmw_ret_t
 __rmw_take_event(
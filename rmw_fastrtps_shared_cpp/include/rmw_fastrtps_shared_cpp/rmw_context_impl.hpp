@@ -15,8 +15,14 @@
 #ifndef RMW_FASTRTPS_SHARED_CPP__RMW_CONTEXT_IMPL_HPP_
 #define RMW_FASTRTPS_SHARED_CPP__RMW_CONTEXT_IMPL_HPP_
 
+#include <memory>
 #include <mutex>
 
+#include "rmw_fastrtps_shared_cpp/graph_change_notifier.hpp"
+#include "rmw_fastrtps_shared_cpp/graph_update_publisher.hpp"
+#include "rmw_fastrtps_shared_cpp/names_and_types_cache.hpp"
+#include "rmw_fastrtps_shared_cpp/response_flusher.hpp"
+
 // Definition of struct rmw_context_impl_s as declared in rmw/init.h
 struct rmw_context_impl_s
 {
@@ -30,6 +36,14 @@ struct rmw_context_impl_s
   uint64_t count;
   /// Shutdown flag.
   bool is_shutdown;
+  /// Publisher of the graph updates of the context.
+  std::unique_ptr<rmw_fastrtps_shared_cpp::GraphUpdatePublisher> graph_update_publisher;
+  /// Notifier of the changes of the graph cache of the context.
+  std::unique_ptr<rmw_fastrtps_shared_cpp::GraphChangeNotifier> graph_change_notifier;
+  /// Writer of the service responses parked until their clients matched.
+  std::unique_ptr<rmw_fastrtps_shared_cpp::ResponseFlusher> response_flusher;
+  /// Snapshots of the names and types queried from the graph cache.
+  rmw_fastrtps_shared_cpp::NamesAndTypesCache names_and_types_cache;
 };
 
 #endif  // RMW_FASTRTPS_SHARED_CPP__RMW_CONTEXT_IMPL_HPP_
@@ -0,0 +1,144 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__SERIALIZED_PAYLOAD_POOL_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__SERIALIZED_PAYLOAD_POOL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "fastdds/rtps/common/CacheChange.h"
+#include "fastdds/rtps/common/SerializedPayload.h"
+#include "fastdds/rtps/common/Types.h"
+#include "fastdds/rtps/history/IPayloadPool.h"
+
+#include "rcpputils/thread_safety_annotations.hpp"
+
+#include "rmw_fastrtps_shared_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Payload pool of a DataWriter which can lend its buffers to the publisher.
+/**
+ * A serialized message written into a borrowed buffer is published without being copied:
+ * the buffer itself becomes the payload of the sample written while a PublishScope for it is
+ * alive.
+ *
+ * Buffers are kept for reuse when the writer releases them, so publishing does not allocate
+ * once enough buffers of the right size have been created.
+ * Unlike the payload pool of Fast DDS, buffers are not preallocated, so it is only used by the
+ * writers which lend their buffers.
+ */
+class SerializedPayloadPool final : public eprosima::fastrtps::rtps::IPayloadPool
+{
+public:
+  using octet = eprosima::fastrtps::rtps::octet;
+
+  /// Hands a borrowed buffer to the writer while the sample is being written by this thread.
+  class PublishScope
+  {
+public:
+    RMW_FASTRTPS_SHARED_CPP_PUBLIC
+    PublishScope(SerializedPayloadPool & pool, octet * buffer);
+
+    RMW_FASTRTPS_SHARED_CPP_PUBLIC
+    ~PublishScope();
+
+    /// Whether the writer has taken the buffer as the payload of a sample.
+    RMW_FASTRTPS_SHARED_CPP_PUBLIC
+    bool
+    buffer_taken() const;
+
+private:
+    SerializedPayloadPool & pool_;
+    octet * buffer_;
+  };
+
+  /// Create a pool keeping up to max_free_buffers released buffers for reuse.
+  /**
+   * It should be the maximum number of samples in the history of the writer, so that every
+   * sample removed from the history leaves a buffer for the next one.
+   */
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  explicit SerializedPayloadPool(size_t max_free_buffers);
+
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  ~SerializedPayloadPool() override = default;
+
+  /// Lend a buffer of at least size bytes.
+  /**
+   * \return nullptr on allocation failure.
+   */
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  octet *
+  borrow(uint32_t size, uint32_t & capacity);
+
+  /// Give back a borrowed buffer which is not going to be published.
+  /**
+   * \return false if the buffer is not currently borrowed from this pool.
+   */
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  bool
+  give_back(octet * buffer);
+
+  /// Whether buffer is currently borrowed from this pool.
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  bool
+  is_borrowed(const octet * buffer);
+
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  bool
+  get_payload(
+    uint32_t size,
+    eprosima::fastrtps::rtps::CacheChange_t & cache_change) override;
+
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  bool
+  get_payload(
+    eprosima::fastrtps::rtps::SerializedPayload_t & data,
+    eprosima::fastrtps::rtps::IPayloadPool * & data_owner,
+    eprosima::fastrtps::rtps::CacheChange_t & cache_change) override;
+
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  bool
+  release_payload(eprosima::fastrtps::rtps::CacheChange_t & cache_change) override;
+
+private:
+  octet *
+  acquire(uint32_t size, uint32_t & capacity) RCPPUTILS_TSA_REQUIRES(mutex_);
+
+  void
+  release(octet * buffer) RCPPUTILS_TSA_REQUIRES(mutex_);
+
+  const size_t max_free_buffers_;
+
+  std::mutex mutex_;
+  // Every buffer of the pool, with its capacity
+  std::unordered_map<octet *, std::pair<std::unique_ptr<octet[]>, uint32_t>> buffers_
+  RCPPUTILS_TSA_GUARDED_BY(mutex_);
+  // Buffers available for reuse, by capacity
+  std::multimap<uint32_t, octet *> free_buffers_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+  std::unordered_set<octet *> borrowed_buffers_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__SERIALIZED_PAYLOAD_POOL_HPP_
@@ -15,9 +15,11 @@
 #ifndef RMW_FASTRTPS_SHARED_CPP__UTILS_HPP_
 #define RMW_FASTRTPS_SHARED_CPP__UTILS_HPP_
 
+#include <memory>
 #include <mutex>
 #include <string>
 
+#include "fastdds/dds/publisher/qos/DataWriterQos.hpp"
 #include "fastdds/dds/topic/TopicDescription.hpp"
 #include "fastdds/dds/topic/TypeSupport.hpp"
 
@@ -25,6 +27,7 @@
 
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_subscriber_info.hpp"
+#include "rmw_fastrtps_shared_cpp/serialized_payload_pool.hpp"
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 
 #include "rmw/rmw.h"
@@ -80,6 +83,70 @@ remove_topic_and_type(
   const eprosima::fastdds::dds::TopicDescription * topic,
   const eprosima::fastdds::dds::TypeSupport & type);
 
+/**
+* Check if an endpoint should use data-sharing delivery.
+*
+* Topics are selected with the environment variable RMW_FASTRTPS_DATA_SHARING_TOPICS, which holds
+* a comma separated list of ROS topic names where '*' matches any sequence of characters.
+* Data-sharing is only used for bounded types, as samples are stored in fixed size segments.
+*
+* \param[in] participant_info CustomParticipantInfo associated to the context.
+* \param[in] topic_name       ROS name of the topic, without the DDS prefix.
+* \param[in] type             TypeSupport registered for the topic.
+*
+* \return true when the endpoint should use data-sharing
+* \return false when the endpoint should not use data-sharing
+*/
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+bool
+use_data_sharing(
+  const CustomParticipantInfo * participant_info,
+  const std::string & topic_name,
+  const eprosima::fastdds::dds::TypeSupport & type);
+
+/**
+* Create the payload pool of a DataWriter lending its buffers to the publisher, if it does.
+*
+* Topics are selected with the environment variable RMW_FASTRTPS_BORROWED_PAYLOAD_TOPICS, which
+* holds a comma separated list of ROS topic names where '*' matches any sequence of characters.
+* Fast DDS only accepts custom payload pools for DataWriters not using data-sharing.
+* The pool keeps as many released buffers as the history of the DataWriter can hold samples.
+*
+* \param[in] participant_info CustomParticipantInfo associated to the context.
+* \param[in] topic_name       ROS name of the topic, without the DDS prefix.
+* \param[in] writer_qos       QoS of the DataWriter.
+*
+* \return the payload pool to create the DataWriter with, or
+* \return nullptr when the DataWriter uses the payload pool of Fast DDS
+*/
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+std::shared_ptr<SerializedPayloadPool>
+create_payload_pool(
+  const CustomParticipantInfo * participant_info,
+  const std::string & topic_name,
+  const eprosima::fastdds::dds::DataWriterQos & writer_qos);
+
+/**
+* Make the DataWriters of a topic publish through a flow controller, if one is configured for it.
+*
+* Topics are assigned to the flow controllers of the participant with the environment variable
+* RMW_FASTRTPS_FLOW_CONTROLLER_TOPICS.
+* Flow controlled DataWriters always use the asynchronous publishing mode.
+*
+* \param[in] participant_info CustomParticipantInfo associated to the context.
+* \param[in] topic_name       ROS name of the topic, without the DDS prefix.
+* \param[inout] writer_qos    QoS of the DataWriter, modified when a flow controller is used.
+*
+* \return true when the DataWriter uses a flow controller
+* \return false when the DataWriter does not use a flow controller
+*/
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+bool
+use_flow_controller(
+  const CustomParticipantInfo * participant_info,
+  const std::string & topic_name,
+  eprosima::fastdds::dds::DataWriterQos & writer_qos);
+
 /**
 * Create content filtered topic.
 *
@@ -103,6 +170,25 @@ create_content_filtered_topic(
   eprosima::fastdds::dds::ContentFilteredTopic ** content_filtered_topic);
 
 
+/**
+* Create the content filtered topic of the response reader of a client.
+*
+* The topic filters out the responses to other clients of the same service, see ResponseFilter.
+*
+* \param[in]  participant             DomainParticipant where the topic will be created.
+* \param[in]  response_topic          Response topic of the service.
+* \param[out] content_filtered_topic  Will hold the pointer to the content filtered topic.
+*
+* \return true when the content filtered topic was created
+* \return false when the content filtered topic could not be created
+*/
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+bool
+create_response_filtered_topic(
+  eprosima::fastdds::dds::DomainParticipant * participant,
+  eprosima::fastdds::dds::Topic * response_topic,
+  eprosima::fastdds::dds::ContentFilteredTopic ** content_filtered_topic);
+
 /**
 * Create data reader.
 *
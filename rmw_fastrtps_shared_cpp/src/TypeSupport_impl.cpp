@@ -13,6 +13,10 @@
 // limitations under the License.
 
 #include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -32,8 +36,12 @@
 #include "fastrtps/types/TypeNamesGenerator.h"
 #include "fastrtps/types/AnnotationParameterValue.h"
 
+#include "rcpputils/scope_exit.hpp"
+#include "rcutils/allocator.h"
+
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 #include "rmw/error_handling.h"
+#include "rmw/serialized_message.h"
 
 #include "rosidl_typesupport_introspection_c/identifier.h"
 #include "rosidl_typesupport_introspection_cpp/identifier.hpp"
@@ -44,24 +52,175 @@
 namespace rmw_fastrtps_shared_cpp
 {
 
+namespace
+{
+
+// ROS message serialized by a size provider of getSerializedSizeProvider, waiting to be copied
+// into the payload by the serialize call that follows on the same thread.
+struct SizeScratch
+{
+  // Largest buffer kept once its content has been consumed
+  static constexpr size_t max_kept_buffer_size = 1024u * 1024u;
+
+  // Generation of the last size provider created on this thread
+  uint64_t last_generation = 0;
+  // Generation of the size provider which serialized the message, 0 when there is none
+  uint64_t generation = 0;
+  const TypeSupport * type_support = nullptr;
+  const void * ros_message = nullptr;
+  std::unique_ptr<eprosima::fastcdr::FastBuffer> buffer;
+  size_t length = 0;
+  eprosima::fastcdr::Cdr::Endianness endianness = eprosima::fastcdr::Cdr::DEFAULT_ENDIAN;
+
+  // Forget the serialized message, releasing the buffer if it grew too large
+  void
+  clear()
+  {
+    generation = 0;
+    if (buffer && buffer->getBufferSize() > max_kept_buffer_size) {
+      buffer.reset();
+    }
+  }
+};
+
+thread_local SizeScratch size_scratch;
+
+// Buffer ROS messages of keyed types are serialized into to compute their key
+thread_local eprosima::fastcdr::FastBuffer key_scratch;
+
+// Sample created by TypeSupport::createData for keyed types, which payloads are copied into
+struct SerializedSample
+{
+  SerializedData data;
+  rmw_serialized_message_t message;
+};
+
+}  // namespace
+
 TypeSupport::TypeSupport()
 {
   m_isGetKeyDefined = false;
   max_size_bound_ = false;
   is_plain_ = false;
+  size_by_serializing_ = false;
+  key_size_ = 0;
+  dynamic_pubsub_type_ = std::make_unique<eprosima::fastrtps::types::DynamicPubSubType>();
   auto_fill_type_object(false);
   auto_fill_type_information(false);
 }
 
+TypeSupport::~TypeSupport() = default;
+
+void TypeSupport::set_key_size(size_t key_size)
+{
+  key_size_ = key_size;
+  m_isGetKeyDefined = key_size > 0u;
+}
+
 void TypeSupport::deleteData(void * data)
 {
   assert(data);
-  delete static_cast<eprosima::fastcdr::FastBuffer *>(data);
+  if (0u == key_size_) {
+    delete static_cast<eprosima::fastcdr::FastBuffer *>(data);
+    return;
+  }
+  // SerializedData is the first member of SerializedSample
+  auto sample = reinterpret_cast<SerializedSample *>(static_cast<SerializedData *>(data));
+  if (RMW_RET_OK != rmw_serialized_message_fini(&sample->message)) {
+    rmw_reset_error();
+  }
+  delete sample;
 }
 
 void * TypeSupport::createData()
 {
-  return new eprosima::fastcdr::FastBuffer();
+  if (0u == key_size_) {
+    return new eprosima::fastcdr::FastBuffer();
+  }
+  // Fast DDS deserializes into these samples the payloads it needs the key of
+  auto sample = new (std::nothrow) SerializedSample();
+  if (!sample) {
+    return nullptr;
+  }
+  sample->message = rmw_get_zero_initialized_serialized_message();
+  sample->message.allocator = rcutils_get_default_allocator();
+  sample->data.type = FASTRTPS_SERIALIZED_DATA_TYPE_SERIALIZED_MESSAGE;
+  sample->data.data = &sample->message;
+  sample->data.impl = nullptr;
+  return &sample->data;
+}
+
+bool TypeSupport::getKey(
+  void * data,
+  eprosima::fastrtps::rtps::InstanceHandle_t * ihandle,
+  bool force_md5)
+{
+  assert(data);
+  assert(ihandle);
+
+  if (0u == key_size_) {
+    return false;
+  }
+
+  // Serialized sample, including the encapsulation
+  const uint8_t * buffer = nullptr;
+  size_t length = 0;
+
+  auto ser_data = static_cast<SerializedData *>(data);
+  switch (ser_data->type) {
+    case FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE:
+      {
+        eprosima::fastcdr::Cdr ser(
+          key_scratch, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN, eprosima::fastcdr::Cdr::DDS_CDR);
+        if (!this->serializeROSmessage(ser_data->data, ser, ser_data->impl)) {
+          return false;
+        }
+        buffer = reinterpret_cast<const uint8_t *>(ser.getBufferPointer());
+        length = ser.getSerializedDataLength();
+        break;
+      }
+
+    case FASTRTPS_SERIALIZED_DATA_TYPE_CDR_BUFFER:
+      {
+        auto ser = static_cast<eprosima::fastcdr::Cdr *>(ser_data->data);
+        buffer = reinterpret_cast<const uint8_t *>(ser->getBufferPointer());
+        length = ser->getSerializedDataLength();
+        break;
+      }
+
+    case FASTRTPS_SERIALIZED_DATA_TYPE_SERIALIZED_MESSAGE:
+      {
+        auto serialized_message = static_cast<rmw_serialized_message_t *>(ser_data->data);
+        buffer = serialized_message->buffer;
+        length = serialized_message->buffer_length;
+        break;
+      }
+
+    default:
+      return false;
+  }
+
+  constexpr size_t encapsulation_size = 4u;
+  if (length < encapsulation_size + key_size_) {
+    return false;
+  }
+  const uint8_t * key = buffer + encapsulation_size;
+
+  // Same rules as the code generated by Fast DDS for keyed types
+  constexpr size_t key_hash_size = 16u;
+  if (force_md5 || key_size_ > key_hash_size) {
+    MD5 md5;
+    md5.init();
+    md5.update(key, static_cast<unsigned int>(key_size_));
+    md5.finalize();
+    for (size_t i = 0; i < key_hash_size; ++i) {
+      ihandle->value[i] = md5.digest[i];
+    }
+  } else {
+    memset(ihandle->value, 0, key_hash_size);
+    memcpy(ihandle->value, key, key_size_);
+  }
+  return true;
 }
 
 bool TypeSupport::serialize(
@@ -75,6 +234,25 @@ bool TypeSupport::serialize(
   switch (ser_data->type) {
     case FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE:
       {
+        // The serialized message is only valid for the serialize call right after the size
+        // provider which was created last, in case a write failed in between
+        if (0u != size_scratch.generation) {
+          auto clear_scratch = rcpputils::make_scope_exit([]() {size_scratch.clear();});
+          if (size_scratch.last_generation == size_scratch.generation &&
+            this == size_scratch.type_support && ser_data->data == size_scratch.ros_message)
+          {
+            // Already serialized when its size was requested
+            if (payload->max_size < size_scratch.length) {
+              return false;
+            }
+            memcpy(payload->data, size_scratch.buffer->getBuffer(), size_scratch.length);
+            payload->encapsulation = size_scratch.endianness ==
+              eprosima::fastcdr::Cdr::BIG_ENDIANNESS ? CDR_BE : CDR_LE;
+            payload->length = static_cast<uint32_t>(size_scratch.length);
+            return true;
+          }
+        }
+
         eprosima::fastcdr::FastBuffer fastbuffer(  // Object that manages the raw buffer
           reinterpret_cast<char *>(payload->data), payload->max_size);
         eprosima::fastcdr::Cdr ser(  // Object that serializes the data
@@ -101,12 +279,27 @@ bool TypeSupport::serialize(
         break;
       }
 
-    case FASTRTPS_SERIALIZED_DATA_TYPE_DYNAMIC_MESSAGE:
+    case FASTRTPS_SERIALIZED_DATA_TYPE_SERIALIZED_MESSAGE:
       {
-        auto m_type = std::make_shared<eprosima::fastrtps::types::DynamicPubSubType>();
+        auto serialized_message = static_cast<rmw_serialized_message_t *>(ser_data->data);
+        if (payload->max_size < serialized_message->buffer_length) {
+          break;
+        }
+        // Nothing to copy when the message was written in a buffer borrowed from the writer
+        if (payload->data != serialized_message->buffer) {
+          memcpy(payload->data, serialized_message->buffer, serialized_message->buffer_length);
+        }
+        payload->length = static_cast<uint32_t>(serialized_message->buffer_length);
+        // The endianness is in the second byte of the encapsulation header
+        payload->encapsulation =
+          (payload->length > 1u && 0u == (payload->data[1] & 0x01u)) ? CDR_BE : CDR_LE;
+        return true;
+      }
 
+    case FASTRTPS_SERIALIZED_DATA_TYPE_DYNAMIC_MESSAGE:
+      {
         // Serializes payload into dynamic data stored in data->data
-        return m_type->serialize(
+        return dynamic_pubsub_type_->serialize(
           static_cast<eprosima::fastrtps::types::DynamicData *>(ser_data->data), payload
         );
       }
@@ -136,6 +329,27 @@ bool TypeSupport::deserialize(
         return deserializeROSmessage(deser, ser_data->data, ser_data->impl);
       }
 
+    case FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE_CURSOR:
+      {
+        auto cursor = static_cast<RosMessageCursor *>(ser_data->data);
+        if (cursor->next >= cursor->count) {
+          return false;
+        }
+        eprosima::fastcdr::FastBuffer fastbuffer(
+          reinterpret_cast<char *>(payload->data), payload->length);
+        eprosima::fastcdr::Cdr deser(
+          fastbuffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN, eprosima::fastcdr::Cdr::DDS_CDR);
+        // A sample that cannot be deserialized is dropped, and the message reused for the next
+        if (!deserializeROSmessage(deser, cursor->messages[cursor->next], ser_data->impl)) {
+          return false;
+        }
+        cursor->next++;
+        return true;
+      }
+
+    case FASTRTPS_SERIALIZED_DATA_TYPE_DISCARD:
+      return true;
+
     case FASTRTPS_SERIALIZED_DATA_TYPE_CDR_BUFFER:
       {
         auto buffer = static_cast<eprosima::fastcdr::FastBuffer *>(ser_data->data);
@@ -146,12 +360,26 @@ bool TypeSupport::deserialize(
         return true;
       }
 
-    case FASTRTPS_SERIALIZED_DATA_TYPE_DYNAMIC_MESSAGE:
+    case FASTRTPS_SERIALIZED_DATA_TYPE_SERIALIZED_MESSAGE:
       {
-        auto m_type = std::make_shared<eprosima::fastrtps::types::DynamicPubSubType>();
+        auto serialized_message = static_cast<rmw_serialized_message_t *>(ser_data->data);
+        if (serialized_message->buffer_capacity < payload->length) {
+          if (RMW_RET_OK != rmw_serialized_message_resize(serialized_message, payload->length)) {
+            // Fast DDS drops samples which fail to deserialize without reporting it, so the
+            // error must not outlive this call
+            rmw_reset_error();
+            return false;
+          }
+        }
+        memcpy(serialized_message->buffer, payload->data, payload->length);
+        serialized_message->buffer_length = payload->length;
+        return true;
+      }
 
+    case FASTRTPS_SERIALIZED_DATA_TYPE_DYNAMIC_MESSAGE:
+      {
         // Deserializes payload into dynamic data stored in data->data (copies!)
-        return m_type->deserialize(
+        return dynamic_pubsub_type_->deserialize(
           payload, static_cast<eprosima::fastrtps::types::DynamicData *>(ser_data->data)
         );
       }
@@ -167,12 +395,40 @@ std::function<uint32_t()> TypeSupport::getSerializedSizeProvider(void * data)
   assert(data);
 
   auto ser_data = static_cast<SerializedData *>(data);
-  auto ser_size = [this, ser_data]() -> uint32_t
+  const uint64_t generation = ++size_scratch.last_generation;
+  auto ser_size = [this, ser_data, generation]() -> uint32_t
     {
       if (ser_data->type == FASTRTPS_SERIALIZED_DATA_TYPE_CDR_BUFFER) {
         auto ser = static_cast<eprosima::fastcdr::Cdr *>(ser_data->data);
         return static_cast<uint32_t>(ser->getSerializedDataLength());
       }
+      if (ser_data->type == FASTRTPS_SERIALIZED_DATA_TYPE_SERIALIZED_MESSAGE) {
+        auto serialized_message = static_cast<rmw_serialized_message_t *>(ser_data->data);
+        return static_cast<uint32_t>(serialized_message->buffer_length);
+      }
+      if (ser_data->type == FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE &&
+        size_by_serializing_ && !is_plain_ && generation == size_scratch.last_generation)
+      {
+        // Serialize once, keeping the result for the serialize call that follows
+        size_scratch.clear();
+        if (!size_scratch.buffer) {
+          size_scratch.buffer.reset(new (std::nothrow) eprosima::fastcdr::FastBuffer());
+        }
+        if (size_scratch.buffer) {
+          eprosima::fastcdr::Cdr ser(
+            *size_scratch.buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN,
+            eprosima::fastcdr::Cdr::DDS_CDR);
+          if (this->serializeROSmessage(ser_data->data, ser, ser_data->impl)) {
+            size_scratch.generation = generation;
+            size_scratch.type_support = this;
+            size_scratch.ros_message = ser_data->data;
+            size_scratch.length = ser.getSerializedDataLength();
+            size_scratch.endianness = ser.endianness();
+            return static_cast<uint32_t>(size_scratch.length);
+          }
+          size_scratch.clear();
+        }
+      }
       return static_cast<uint32_t>(
         this->getEstimatedSerializedSize(ser_data->data, ser_data->impl));
     };
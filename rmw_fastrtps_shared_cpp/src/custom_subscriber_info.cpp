@@ -338,34 +338,16 @@ RMWSubscriptionEvent::set_on_new_message_callback(
   const void * user_data,
   rmw_event_callback_t callback)
 {
+  on_new_message_slot_.set(callback, user_data);
+
   if (callback) {
+    // Report the messages received before the callback was set, marking them as read so they
+    // are only reported once
     auto unread_messages = subscriber_info_->data_reader_->get_unread_count(true);
 
-    std::lock_guard<std::mutex> lock_mutex(on_new_message_m_);
-
     if (0 < unread_messages) {
-      callback(user_data, unread_messages);
+      on_new_message_slot_.call(unread_messages);
     }
-
-    new_message_user_data_ = user_data;
-    on_new_message_cb_ = callback;
-
-    eprosima::fastdds::dds::StatusMask status_mask =
-      subscriber_info_->data_reader_->get_status_mask();
-    status_mask |= eprosima::fastdds::dds::StatusMask::data_available();
-    subscriber_info_->data_reader_->set_listener(
-      subscriber_info_->data_reader_listener_, status_mask);
-  } else {
-    std::lock_guard<std::mutex> lock_mutex(on_new_message_m_);
-
-    eprosima::fastdds::dds::StatusMask status_mask =
-      subscriber_info_->data_reader_->get_status_mask();
-    status_mask &= ~eprosima::fastdds::dds::StatusMask::data_available();
-    subscriber_info_->data_reader_->set_listener(
-      subscriber_info_->data_reader_listener_, status_mask);
-
-    new_message_user_data_ = nullptr;
-    on_new_message_cb_ = nullptr;
   }
 }
 
@@ -375,6 +357,12 @@ size_t RMWSubscriptionEvent::publisher_count() const
   return publishers_.size();
 }
 
+bool RMWSubscriptionEvent::is_publisher_tracked(const eprosima::fastrtps::rtps::GUID_t & guid) const
+{
+  std::lock_guard<std::mutex> lock(publishers_mutex_);
+  return publishers_.count(guid) > 0u;
+}
+
 void RMWSubscriptionEvent::track_unique_publisher(eprosima::fastrtps::rtps::GUID_t guid)
 {
   std::lock_guard<std::mutex> lock(publishers_mutex_);
@@ -389,15 +377,10 @@ void RMWSubscriptionEvent::untrack_unique_publisher(eprosima::fastrtps::rtps::GU
 
 void RMWSubscriptionEvent::update_data_available()
 {
-  std::unique_lock<std::mutex> lock_mutex(on_new_message_m_);
-
-  if (on_new_message_cb_) {
-    auto unread_messages = subscriber_info_->data_reader_->get_unread_count(true);
+  subscriber_info_->ready_counter_.notify();
 
-    if (0 < unread_messages) {
-      on_new_message_cb_(new_message_user_data_, unread_messages);
-    }
-  }
+  // Fast DDS notifies each new message, so there is no need to ask the reader how many arrived
+  on_new_message_slot_.call(1u);
 }
 
 void RMWSubscriptionEvent::update_requested_deadline_missed(
@@ -24,6 +24,7 @@
 #include "rmw_fastrtps_shared_cpp/namespace_prefix.hpp"
 
 #include "demangle.hpp"
+#include "name_cache.hpp"
 
 /// Return the demangle ROS topic or the original if not a ROS topic.
 std::string
@@ -62,6 +63,36 @@ _demangle_ros_topic_from_topic(const std::string & topic_name)
   return _resolve_prefix(topic_name, ros_topic_prefix);
 }
 
+// Demangle name with demangle, or get the result of a previous call from cache
+static std::string
+_demangle_cached(
+  rmw_fastrtps_shared_cpp::NameCache & cache,
+  DemangleFunction demangle,
+  const std::string & name)
+{
+  const std::string * cached = cache.find(name);
+  if (cached) {
+    return *cached;
+  }
+  std::string demangled = demangle(name);
+  cache.insert(name, demangled);
+  return demangled;
+}
+
+std::string
+_demangle_ros_topic_from_topic_cached(const std::string & topic_name)
+{
+  static rmw_fastrtps_shared_cpp::NameCache cache;
+  return _demangle_cached(cache, _demangle_ros_topic_from_topic, topic_name);
+}
+
+std::string
+_demangle_if_ros_type_cached(const std::string & dds_type_string)
+{
+  static rmw_fastrtps_shared_cpp::NameCache cache;
+  return _demangle_cached(cache, _demangle_if_ros_type, dds_type_string);
+}
+
 /// Return the service name for a given topic if it is part of one, else "".
 std::string
 _demangle_service_from_topic(
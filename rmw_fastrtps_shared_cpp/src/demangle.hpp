@@ -30,6 +30,14 @@ _demangle_if_ros_type(const std::string & dds_type_string);
 std::string
 _demangle_ros_topic_from_topic(const std::string & topic_name);
 
+/// Same as _demangle_ros_topic_from_topic, demangling each topic only once per process.
+std::string
+_demangle_ros_topic_from_topic_cached(const std::string & topic_name);
+
+/// Same as _demangle_if_ros_type, demangling each type only once per process.
+std::string
+_demangle_if_ros_type_cached(const std::string & dds_type_string);
+
 /// Return the service name for a given topic if it is part of a service, else "".
 std::string
 _demangle_service_from_topic(const std::string & topic_name);
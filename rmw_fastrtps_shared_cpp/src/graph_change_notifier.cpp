@@ -0,0 +1,111 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+
+#include "rcutils/env.h"
+#include "rcutils/logging_macros.h"
+
+#include "rmw/error_handling.h"
+
+#include "rmw_fastrtps_shared_cpp/graph_change_notifier.hpp"
+#include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+
+#include "string_utils.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+std::unique_ptr<GraphChangeNotifier>
+GraphChangeNotifier::create(const char * identifier, rmw_dds_common::Context * common_context)
+{
+  std::chrono::milliseconds period = default_period;
+  const char * env_value = nullptr;
+  const char * error_str = rcutils_get_env("RMW_FASTRTPS_GRAPH_CHANGE_PERIOD", &env_value);
+  if (error_str != NULL) {
+    RMW_SET_ERROR_MSG_WITH_FORMAT_STRING("Error getting env var: %s\n", error_str);
+    return nullptr;
+  }
+  if (env_value != nullptr && '\0' != env_value[0]) {
+    int64_t value = 0;
+    if (parse_integer(env_value, 0, std::numeric_limits<int32_t>::max(), value)) {
+      period = std::chrono::milliseconds(value);
+    } else {
+      RCUTILS_LOG_WARN_NAMED(
+        "rmw_fastrtps_shared_cpp",
+        "Value %s unknown for environment variable RMW_FASTRTPS_GRAPH_CHANGE_PERIOD"
+        ". Using default period of %lld ms.", env_value,
+        static_cast<long long>(default_period.count()));  // NOLINT(runtime/int)
+    }
+  }
+
+  std::unique_ptr<GraphChangeNotifier> notifier(
+    new (std::nothrow) GraphChangeNotifier(identifier, common_context, period));
+  if (!notifier) {
+    RMW_SET_ERROR_MSG("failed to allocate graph change notifier");
+  }
+  return notifier;
+}
+
+GraphChangeNotifier::GraphChangeNotifier(
+  const char * identifier,
+  rmw_dds_common::Context * common_context,
+  std::chrono::milliseconds period)
+: trigger_(
+    period,
+    [identifier, common_context]() {
+      return __rmw_trigger_guard_condition(identifier, common_context->graph_guard_condition);
+    },
+    // Wake the listener thread up, so it waits for the end of the period
+    [identifier, common_context]() {
+      return __rmw_trigger_guard_condition(identifier, common_context->listener_thread_gc);
+    }),
+  common_context_(common_context)
+{
+}
+
+void
+GraphChangeNotifier::notify()
+{
+  // Without the listener thread nobody would notify pending changes
+  static_cast<void>(trigger_.request(!common_context_->thread_is_running.load()));
+  if (!common_context_->thread_is_running.load()) {
+    // The thread stopped after the change became pending
+    static_cast<void>(trigger_.flush());
+  }
+}
+
+void
+GraphChangeNotifier::notify_pending()
+{
+  static_cast<void>(trigger_.run_pending());
+}
+
+void
+GraphChangeNotifier::flush()
+{
+  static_cast<void>(trigger_.flush());
+}
+
+bool
+GraphChangeNotifier::get_pending_deadline(std::chrono::steady_clock::time_point & deadline)
+{
+  return trigger_.get_pending_deadline(deadline);
+}
+
+}  // namespace rmw_fastrtps_shared_cpp
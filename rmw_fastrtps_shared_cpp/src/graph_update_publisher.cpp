@@ -0,0 +1,83 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <mutex>
+
+#include "rmw/error_handling.h"
+
+#include "rmw_fastrtps_shared_cpp/graph_update_publisher.hpp"
+#include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+GraphUpdatePublisher::GraphUpdatePublisher(
+  const char * identifier,
+  rmw_dds_common::Context * common_context)
+: identifier_(identifier),
+  common_context_(common_context),
+  publication_(
+    period,
+    [this]() {return publish_latest();},
+    // Wake the listener thread up, so it waits for the end of the period
+    [identifier, common_context]() {
+      return __rmw_trigger_guard_condition(identifier, common_context->listener_thread_gc);
+    })
+{
+}
+
+rmw_ret_t
+GraphUpdatePublisher::publish(const ParticipantEntitiesInfo & msg)
+{
+  {
+    std::lock_guard<std::mutex> guard(update_mutex_);
+    latest_update_ = msg;
+  }
+  // Without the listener thread nobody would publish a pending update
+  rmw_ret_t ret = publication_.request(!common_context_->thread_is_running.load());
+  if (RMW_RET_OK == ret && !common_context_->thread_is_running.load()) {
+    // The thread stopped after the update became pending
+    ret = publication_.flush();
+  }
+  return ret;
+}
+
+rmw_ret_t
+GraphUpdatePublisher::publish_pending()
+{
+  return publication_.run_pending();
+}
+
+rmw_ret_t
+GraphUpdatePublisher::flush()
+{
+  return publication_.flush();
+}
+
+bool
+GraphUpdatePublisher::get_pending_deadline(std::chrono::steady_clock::time_point & deadline)
+{
+  return publication_.get_pending_deadline(deadline);
+}
+
+rmw_ret_t
+GraphUpdatePublisher::publish_latest()
+{
+  std::lock_guard<std::mutex> guard(update_mutex_);
+  return __rmw_publish(
+    identifier_, common_context_->pub, static_cast<const void *>(&latest_update_), nullptr);
+}
+
+}  // namespace rmw_fastrtps_shared_cpp
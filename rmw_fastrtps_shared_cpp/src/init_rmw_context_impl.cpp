@@ -95,6 +95,9 @@ rmw_fastrtps_shared_cpp::decrement_context_impl_ref_count(
   }
 
   common_context->graph_cache.clear_on_change_callback();
+  context->impl->graph_change_notifier.reset();
+  // Snapshots of the graph of this participant must not be reused by the next one
+  context->impl->names_and_types_cache.invalidate();
   if (RMW_RET_OK != rmw_fastrtps_shared_cpp::__rmw_destroy_guard_condition(
       common_context->graph_guard_condition))
   {
@@ -103,6 +106,10 @@ rmw_fastrtps_shared_cpp::decrement_context_impl_ref_count(
       "couldn't destroy graph_guard_condtion");
   }
 
+  // The listener thread has published the last pending graph update and written the last parked
+  // responses before exiting
+  context->impl->graph_update_publisher.reset();
+  context->impl->response_flusher.reset();
   delete common_context;
   context->impl->common = nullptr;
   context->impl->participant_info = nullptr;
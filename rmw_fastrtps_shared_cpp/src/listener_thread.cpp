@@ -12,11 +12,25 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <cassert>
-#include <cstring>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <new>
 #include <thread>
+#include <utility>
 
+#include "fastdds/dds/core/condition/GuardCondition.hpp"
+#include "fastdds/dds/core/condition/WaitSet.hpp"
+#include "fastdds/dds/subscriber/SampleInfo.hpp"
+#include "fastdds/rtps/common/InstanceHandle.h"
+#include "fastdds/rtps/common/SerializedPayload.h"
+
+#include "rcpputils/scope_exit.hpp"
+#include "rcutils/allocator.h"
 #include "rcutils/macros.h"
 
 #include "rmw/allocators.h"
@@ -24,6 +38,7 @@
 #include "rmw/init.h"
 #include "rmw/ret_types.h"
 #include "rmw/rmw.h"
+#include "rmw/serialized_message.h"
 #include "rmw/types.h"
 #include "rmw/impl/cpp/macros.hpp"
 
@@ -31,9 +46,12 @@
 #include "rmw_dds_common/gid_utils.hpp"
 #include "rmw_dds_common/msg/participant_entities_info.hpp"
 
+#include "rmw_fastrtps_shared_cpp/custom_subscriber_info.hpp"
 #include "rmw_fastrtps_shared_cpp/listener_thread.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_context_impl.hpp"
+#include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
+#include "types/serialized_data_sequence.hpp"
 
 using rmw_dds_common::operator<<;
 
@@ -113,6 +131,195 @@ rmw_fastrtps_shared_cpp::join_listener_thread(
       ": ros discovery info listener thread will shutdown ...\n"); \
   }
 
+#define LOG_GRAPH_UPDATE_ERROR() \
+  { \
+    RCUTILS_SAFE_FWRITE_TO_STDERR( \
+      RCUTILS_STRINGIFY(__FILE__) ":" RCUTILS_STRINGIFY(__function__) ":" \
+      RCUTILS_STRINGIFY(__LINE__) ": failed to publish pending graph update: "); \
+    RCUTILS_SAFE_FWRITE_TO_STDERR(rmw_get_error_string().str); \
+    RCUTILS_SAFE_FWRITE_TO_STDERR("\n"); \
+    rmw_reset_error(); \
+  }
+
+namespace
+{
+
+// Ingests the ParticipantEntitiesInfo snapshots of the other participants into the graph cache.
+// Samples are taken in batches without being deserialized. Only the last snapshot of each
+// participant in a batch is deserialized, and it is only applied when it differs from the
+// snapshot of that participant which was applied last.
+// Every participant publishes its snapshots with a single writer, which identifies it whether
+// ros_discovery_info is keyed or not.
+class DiscoveryInfoIngestor
+{
+public:
+  // Number of samples taken at once
+  static constexpr size_t batch_size = 64u;
+
+  explicit DiscoveryInfoIngestor(rmw_dds_common::Context * common_context)
+  : common_context_(common_context),
+    info_(static_cast<CustomSubscriberInfo *>(common_context->sub->data))
+  {
+    for (size_t ii = 0; ii < batch_size; ++ii) {
+      buffers_[ii] = rmw_get_zero_initialized_serialized_message();
+      buffers_[ii].allocator = rcutils_get_default_allocator();
+      data_[ii].type = FASTRTPS_SERIALIZED_DATA_TYPE_SERIALIZED_MESSAGE;
+      data_[ii].data = &buffers_[ii];
+      data_[ii].impl = nullptr;
+      data_pointers_[ii] = &data_[ii];
+    }
+  }
+
+  ~DiscoveryInfoIngestor()
+  {
+    for (auto & buffer : buffers_) {
+      static_cast<void>(rmw_serialized_message_fini(&buffer));
+    }
+  }
+
+  // Take and ingest everything available.
+  // Returns false when the reader fails.
+  bool
+  drain()
+  {
+    size_t received = batch_size;
+    while (batch_size == received) {
+      if (!ingest_batch(received)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  bool
+  ingest_batch(size_t & received)
+  {
+    received = 0u;
+    const auto max_samples =
+      static_cast<eprosima::fastdds::dds::LoanableCollection::size_type>(batch_size);
+    SerializedDataSequence data_values(data_pointers_.data(), max_samples);
+    eprosima::fastdds::dds::SampleInfoSeq info_seq{max_samples};
+
+    ReturnCode_t ret = info_->ready_counter_.take(
+      info_->data_reader_, data_values, info_seq, max_samples);
+    if (ReturnCode_t::RETCODE_NO_DATA == ret) {
+      return true;
+    }
+    if (ReturnCode_t::RETCODE_OK != ret) {
+      return false;
+    }
+    received = static_cast<size_t>(info_seq.length());
+
+    latest_samples_.clear();
+    for (size_t ii = 0; ii < received; ++ii) {
+      if (info_seq[ii].valid_data) {
+        latest_samples_[info_seq[ii].publication_handle] = ii;
+      }
+    }
+
+    for (size_t ii = 0; ii < received; ++ii) {
+      const eprosima::fastdds::dds::SampleInfo & sample_info = info_seq[ii];
+      if (!sample_info.valid_data) {
+        if (eprosima::fastdds::dds::ALIVE_INSTANCE_STATE != sample_info.instance_state) {
+          // The participant is gone
+          applied_snapshots_.erase(sample_info.publication_handle);
+        }
+        continue;
+      }
+      if (latest_samples_[sample_info.publication_handle] != ii) {
+        // Superseded by a later snapshot of the same batch
+        continue;
+      }
+      auto writer_guid = eprosima::fastrtps::rtps::iHandle2GUID(sample_info.publication_handle);
+      if (writer_guid.guidPrefix == info_->data_reader_->guid().guidPrefix) {
+        // ignore local messages
+        continue;
+      }
+      ingest(sample_info.publication_handle, buffers_[ii]);
+    }
+
+    data_values.length(0);
+    info_seq.length(0);
+    prune();
+    return true;
+  }
+
+  // Forget the snapshots of the writers which are not matched anymore.
+  // Unkeyed topics do not tell when a writer is gone while others are left.
+  void
+  prune()
+  {
+    if (applied_snapshots_.size() <= info_->subscription_event_->publisher_count()) {
+      return;
+    }
+    for (auto it = applied_snapshots_.begin(); it != applied_snapshots_.end(); ) {
+      if (info_->subscription_event_->is_publisher_tracked(
+          eprosima::fastrtps::rtps::iHandle2GUID(it->first)))
+      {
+        ++it;
+      } else {
+        it = applied_snapshots_.erase(it);
+      }
+    }
+  }
+
+  void
+  ingest(
+    const eprosima::fastrtps::rtps::InstanceHandle_t & writer,
+    const rmw_serialized_message_t & buffer)
+  {
+    eprosima::fastrtps::rtps::SerializedPayload_t payload;
+    payload.data = buffer.buffer;
+    payload.length = static_cast<uint32_t>(buffer.buffer_length);
+
+    rmw_fastrtps_shared_cpp::SerializedData ros_data;
+    ros_data.type = FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE;
+    ros_data.data = &msg_;
+    ros_data.impl = info_->type_support_impl_;
+
+    const bool deserialized = info_->type_support_->deserialize(&payload, &ros_data);
+    // The buffer is not owned by the payload
+    payload.data = nullptr;
+    if (!deserialized) {
+      // Dropped, as Fast DDS does with samples it cannot deserialize
+      return;
+    }
+
+    auto applied = applied_snapshots_.find(writer);
+    if (applied != applied_snapshots_.end() && applied->second == msg_) {
+      // Nothing changed for this participant
+      return;
+    }
+    common_context_->graph_cache.update_participant_entities(msg_);
+    if (applied != applied_snapshots_.end()) {
+      std::swap(applied->second, msg_);
+    } else {
+      applied_snapshots_.emplace(writer, std::move(msg_));
+      msg_ = rmw_dds_common::msg::ParticipantEntitiesInfo();
+    }
+  }
+
+  rmw_dds_common::Context * common_context_;
+  CustomSubscriberInfo * info_;
+
+  std::array<rmw_serialized_message_t, batch_size> buffers_;
+  std::array<rmw_fastrtps_shared_cpp::SerializedData, batch_size> data_;
+  std::array<void *, batch_size> data_pointers_;
+
+  // Index of the last valid sample of each writer in the current batch
+  std::map<eprosima::fastrtps::rtps::InstanceHandle_t, size_t> latest_samples_;
+  // Last snapshot applied to the graph cache for each writer
+  std::map<
+    eprosima::fastrtps::rtps::InstanceHandle_t,
+    rmw_dds_common::msg::ParticipantEntitiesInfo> applied_snapshots_;
+
+  // Deserialization target, reused across samples
+  rmw_dds_common::msg::ParticipantEntitiesInfo msg_;
+};
+
+}  // namespace
+
 void
 node_listener(
   rmw_context_t * context)
@@ -120,70 +327,90 @@ node_listener(
   assert(nullptr != context);
   assert(nullptr != context->impl);
   assert(nullptr != context->impl->common);
+  assert(nullptr != context->impl->graph_update_publisher);
+  assert(nullptr != context->impl->graph_change_notifier);
+  assert(nullptr != context->impl->response_flusher);
   auto common_context = static_cast<rmw_dds_common::Context *>(context->impl->common);
-  // number of conditions of a subscription is 2
-  rmw_wait_set_t * wait_set = rmw_fastrtps_shared_cpp::__rmw_create_wait_set(
-    context->implementation_identifier, context, 2);
-  if (nullptr == wait_set) {
-    LOG_THREAD_FATAL_ERROR("failed to create waitset");
+  auto graph_update_publisher = context->impl->graph_update_publisher.get();
+  auto graph_change_notifier = context->impl->graph_change_notifier.get();
+  auto response_flusher = context->impl->response_flusher.get();
+  assert(nullptr != common_context->sub);
+  assert(nullptr != common_context->sub->data);
+  auto info = static_cast<CustomSubscriberInfo *>(common_context->sub->data);
+  auto listener_thread_gc = static_cast<eprosima::fastdds::dds::GuardCondition *>(
+    common_context->listener_thread_gc->data);
+
+  // However the thread stops, nobody would serve the requests left pending, so they are served
+  // here, and the following ones are served right away
+  auto serve_pending_requests = rcpputils::make_scope_exit(
+    [&]() {
+      common_context->thread_is_running.store(false);
+      if (RMW_RET_OK != graph_update_publisher->flush()) {
+        LOG_GRAPH_UPDATE_ERROR();
+      }
+      graph_change_notifier->flush();
+      response_flusher->flush();
+    });
+
+  std::unique_ptr<DiscoveryInfoIngestor> ingestor;
+  // Both conditions stay attached for the whole life of the thread
+  eprosima::fastdds::dds::WaitSet wait_set;
+  eprosima::fastdds::dds::ConditionSeq triggered_conditions;
+  try {
+    ingestor = std::make_unique<DiscoveryInfoIngestor>(common_context);
+    if (ReturnCode_t::RETCODE_OK != wait_set.attach_condition(
+        info->data_reader_->get_statuscondition()) ||
+      ReturnCode_t::RETCODE_OK != wait_set.attach_condition(*listener_thread_gc))
+    {
+      LOG_THREAD_FATAL_ERROR("failed to attach conditions to waitset");
+      return;
+    }
+  } catch (const std::bad_alloc &) {
+    LOG_THREAD_FATAL_ERROR("failed to create discovery info ingestor");
     return;
   }
+
   while (common_context->thread_is_running.load()) {
-    assert(nullptr != common_context->sub);
-    assert(nullptr != common_context->sub->data);
-    void * subscriptions_buffer[] = {common_context->sub->data};
-    void * guard_conditions_buffer[] = {common_context->listener_thread_gc->data};
-    rmw_subscriptions_t subscriptions;
-    rmw_guard_conditions_t guard_conditions;
-    subscriptions.subscriber_count = 1;
-    subscriptions.subscribers = subscriptions_buffer;
-    guard_conditions.guard_condition_count = 1;
-    guard_conditions.guard_conditions = guard_conditions_buffer;
-    if (RMW_RET_OK != rmw_fastrtps_shared_cpp::__rmw_wait(
-        context->implementation_identifier,
-        &subscriptions,
-        &guard_conditions,
-        nullptr,
-        nullptr,
-        nullptr,
-        wait_set,
-        nullptr))
-    {
-      LOG_THREAD_FATAL_ERROR("rmw_wait failed");
-      break;
-    }
-    if (subscriptions_buffer[0]) {
-      rmw_dds_common::msg::ParticipantEntitiesInfo msg;
-      bool taken = true;
-
-      while (taken) {
-        if (RMW_RET_OK != rmw_fastrtps_shared_cpp::__rmw_take(
-            context->implementation_identifier,
-            common_context->sub,
-            static_cast<void *>(&msg),
-            &taken,
-            nullptr))
-        {
-          LOG_THREAD_FATAL_ERROR("__rmw_take failed");
-          break;
-        }
-        if (taken) {
-          if (std::memcmp(
-              reinterpret_cast<char *>(common_context->gid.data),
-              reinterpret_cast<char *>(&msg.gid.data),
-              RMW_GID_STORAGE_SIZE) == 0)
-          {
-            // ignore local messages
-            continue;
-          }
-          common_context->graph_cache.update_participant_entities(msg);
+    if (!info->ready_counter_.is_ready() && !listener_thread_gc->get_trigger_value()) {
+      // Wake up in time to publish the pending graph update and to notify the pending graph
+      // changes, if any
+      Duration_t timeout = eprosima::fastrtps::c_TimeInfinite;
+      auto deadline = std::chrono::steady_clock::time_point::max();
+      std::chrono::steady_clock::time_point pending_deadline;
+      if (graph_update_publisher->get_pending_deadline(pending_deadline)) {
+        deadline = std::min(deadline, pending_deadline);
+      }
+      if (graph_change_notifier->get_pending_deadline(pending_deadline)) {
+        deadline = std::min(deadline, pending_deadline);
+      }
+      if (std::chrono::steady_clock::time_point::max() != deadline) {
+        auto left = std::chrono::duration_cast<std::chrono::nanoseconds>(
+          deadline - std::chrono::steady_clock::now());
+        if (left.count() < 0) {
+          left = std::chrono::nanoseconds::zero();
         }
+        timeout = Duration_t{
+          static_cast<int32_t>(left.count() / 1000000000),
+          static_cast<uint32_t>(left.count() % 1000000000)};
+      }
+      ReturnCode_t ret_code = wait_set.wait(triggered_conditions, timeout);
+      if (ReturnCode_t::RETCODE_OK != ret_code && ReturnCode_t::RETCODE_TIMEOUT != ret_code) {
+        LOG_THREAD_FATAL_ERROR("waitset wait failed");
+        break;
       }
     }
+    listener_thread_gc->set_trigger_value(false);
+
+    if (RMW_RET_OK != graph_update_publisher->publish_pending()) {
+      LOG_GRAPH_UPDATE_ERROR();
+    }
+    graph_change_notifier->notify_pending();
+    response_flusher->flush();
+    if (!ingestor->drain()) {
+      LOG_THREAD_FATAL_ERROR("failed to take discovery info");
+      break;
+    }
   }
-  if (RMW_RET_OK != rmw_fastrtps_shared_cpp::__rmw_destroy_wait_set(
-      context->implementation_identifier, wait_set))
-  {
-    LOG_THREAD_FATAL_ERROR("failed to destroy waitset");
-  }
+  wait_set.detach_condition(*listener_thread_gc);
+  wait_set.detach_condition(info->data_reader_->get_statuscondition());
 }
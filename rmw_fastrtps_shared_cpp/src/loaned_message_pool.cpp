@@ -0,0 +1,189 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <mutex>
+#include <new>
+
+#include "rcutils/error_handling.h"
+
+#include "rosidl_runtime_c/message_initialization.h"
+#include "rosidl_runtime_cpp/message_initialization.hpp"
+
+#include "rosidl_typesupport_introspection_c/identifier.h"
+#include "rosidl_typesupport_introspection_c/message_introspection.h"
+#include "rosidl_typesupport_introspection_cpp/identifier.hpp"
+#include "rosidl_typesupport_introspection_cpp/message_introspection.hpp"
+
+#include "rmw_fastrtps_shared_cpp/loaned_message_pool.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+LoanedMessagePool::~LoanedMessagePool()
+{
+  uint8_t * base = reinterpret_cast<uint8_t *>(arena_.get());
+  for (size_t i = 0; i < initialized_; ++i) {
+    fini_function_(base + i * stride_);
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (void * message : overflow_messages_) {
+    free_message(message);
+  }
+}
+
+std::unique_ptr<LoanedMessagePool>
+LoanedMessagePool::create(const rosidl_message_type_support_t * type_supports, size_t pool_size)
+{
+  if (0u == pool_size) {
+    return nullptr;
+  }
+
+  // Not finding an introspection type support is not an error, the publisher just won't loan
+  const rosidl_message_type_support_t * type_support = get_message_typesupport_handle(
+    type_supports, rosidl_typesupport_introspection_c__identifier);
+  const rosidl_message_type_support_t * type_support_cpp = nullptr;
+  if (!type_support) {
+    rcutils_reset_error();
+    type_support_cpp = get_message_typesupport_handle(
+      type_supports, rosidl_typesupport_introspection_cpp::typesupport_identifier);
+    if (!type_support_cpp) {
+      rcutils_reset_error();
+      return nullptr;
+    }
+  }
+
+  size_t size_of = 0;
+  if (type_support) {
+    auto members = static_cast<const rosidl_typesupport_introspection_c__MessageMembers *>(
+      type_support->data);
+    size_of = members->size_of_;
+  } else {
+    auto members = static_cast<const rosidl_typesupport_introspection_cpp::MessageMembers *>(
+      type_support_cpp->data);
+    size_of = members->size_of_;
+  }
+
+  std::unique_ptr<LoanedMessagePool> pool(new (std::nothrow) LoanedMessagePool());
+  if (!pool) {
+    return nullptr;
+  }
+
+  // Keep every message aligned as if it had been allocated on its own
+  const size_t alignment = alignof(std::max_align_t);
+  const size_t slots_per_message = (size_of + alignment - 1) / alignment;
+  pool->stride_ = slots_per_message * alignment;
+  pool->pool_size_ = pool_size;
+  pool->arena_.reset(new (std::nothrow) std::max_align_t[slots_per_message * pool_size]);
+  if (!pool->arena_) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(pool->mutex_);
+  pool->free_messages_.reserve(pool_size);
+  pool->loaned_.assign(pool_size, false);
+  if (type_support) {
+    auto members = static_cast<const rosidl_typesupport_introspection_c__MessageMembers *>(
+      type_support->data);
+    pool->init_function_ = [members](void * message) {
+        members->init_function(message, ROSIDL_RUNTIME_C_MSG_INIT_ALL);
+      };
+    pool->fini_function_ = members->fini_function;
+  } else {
+    auto members = static_cast<const rosidl_typesupport_introspection_cpp::MessageMembers *>(
+      type_support_cpp->data);
+    pool->init_function_ = [members](void * message) {
+        members->init_function(message, rosidl_runtime_cpp::MessageInitialization::ALL);
+      };
+    pool->fini_function_ = members->fini_function;
+  }
+  uint8_t * base = reinterpret_cast<uint8_t *>(pool->arena_.get());
+  for (size_t i = 0; i < pool_size; ++i) {
+    pool->init_function_(base + i * pool->stride_);
+    pool->initialized_++;
+  }
+
+  // Loan messages in address order
+  for (size_t i = pool_size; i > 0; --i) {
+    pool->free_messages_.push_back(base + (i - 1) * pool->stride_);
+  }
+
+  return pool;
+}
+
+void *
+LoanedMessagePool::borrow()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (free_messages_.empty()) {
+    void * message = allocate_message();
+    if (nullptr != message) {
+      try {
+        overflow_messages_.insert(message);
+      } catch (std::bad_alloc &) {
+        free_message(message);
+        return nullptr;
+      }
+    }
+    return message;
+  }
+  uint8_t * message = free_messages_.back();
+  free_messages_.pop_back();
+  loaned_[static_cast<size_t>(message - reinterpret_cast<uint8_t *>(arena_.get())) / stride_] =
+    true;
+  return message;
+}
+
+bool
+LoanedMessagePool::release(void * message)
+{
+  uint8_t * base = reinterpret_cast<uint8_t *>(arena_.get());
+  uint8_t * ptr = static_cast<uint8_t *>(message);
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (ptr < base || ptr >= base + pool_size_ * stride_) {
+    if (0u == overflow_messages_.erase(message)) {
+      return false;
+    }
+    free_message(message);
+    return true;
+  }
+
+  const size_t offset = static_cast<size_t>(ptr - base);
+  if (0u != offset % stride_ || !loaned_[offset / stride_]) {
+    return false;
+  }
+  loaned_[offset / stride_] = false;
+  free_messages_.push_back(ptr);
+  return true;
+}
+
+void *
+LoanedMessagePool::allocate_message()
+{
+  std::max_align_t * message =
+    new (std::nothrow) std::max_align_t[stride_ / alignof(std::max_align_t)];
+  if (nullptr != message) {
+    init_function_(message);
+  }
+  return message;
+}
+
+void
+LoanedMessagePool::free_message(void * message)
+{
+  fini_function_(message);
+  delete[] static_cast<std::max_align_t *>(message);
+}
+
+}  // namespace rmw_fastrtps_shared_cpp
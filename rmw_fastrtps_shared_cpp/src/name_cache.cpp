@@ -0,0 +1,46 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "name_cache.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+const std::string *
+NameCache::find(std::string_view name)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = values_.find(name);
+  return values_.end() != it ? &it->second : nullptr;
+}
+
+const std::string *
+NameCache::insert(std::string_view name, const std::string & value)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = values_.find(name);
+  if (values_.end() != it) {
+    return &it->second;
+  }
+  if (values_.size() >= max_entries) {
+    return nullptr;
+  }
+  return &values_.emplace(std::string(name), value).first->second;
+}
+
+}  // namespace rmw_fastrtps_shared_cpp
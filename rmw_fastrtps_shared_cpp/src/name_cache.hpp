@@ -0,0 +1,59 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAME_CACHE_HPP_
+#define NAME_CACHE_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "rcpputils/thread_safety_annotations.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Interned values derived from names, e.g. their demangled or mangled forms.
+/**
+ * Values are never removed, so the pointers returned stay valid for the life of the cache.
+ * Once max_entries values are stored, no other value is stored.
+ */
+class NameCache
+{
+public:
+  static constexpr size_t max_entries = 16384u;
+
+  /// Value stored for name, or nullptr if there is none.
+  const std::string *
+  find(std::string_view name);
+
+  /// Store the value for name.
+  /**
+   * \return the value stored for name, which is the previous one if name was already stored,
+   *   or nullptr if the cache is full.
+   */
+  const std::string *
+  insert(std::string_view name, const std::string & value);
+
+private:
+  std::mutex mutex_;
+  std::map<std::string, std::string, std::less<>> values_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // NAME_CACHE_HPP_
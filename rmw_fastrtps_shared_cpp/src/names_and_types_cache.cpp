@@ -0,0 +1,149 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rcutils/strdup.h"
+#include "rcutils/types/string_array.h"
+
+#include "rmw/convert_rcutils_ret_to_rmw_ret.h"
+#include "rmw/error_handling.h"
+
+#include "rmw_fastrtps_shared_cpp/names_and_types_cache.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+void
+NamesAndTypesCache::invalidate()
+{
+  generation_.fetch_add(1u);
+}
+
+uint64_t
+NamesAndTypesCache::generation() const
+{
+  return generation_.load();
+}
+
+rmw_ret_t
+NamesAndTypesCache::get(
+  const std::string & key,
+  const QueryFunction & query,
+  rcutils_allocator_t * allocator,
+  rmw_names_and_types_t * names_and_types)
+{
+  // Read before querying, so a change during the query invalidates its snapshot
+  const uint64_t generation = generation_.load();
+  std::shared_ptr<const Entries> entries;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = snapshots_.find(key);
+    if (it != snapshots_.end() && it->second.generation == generation) {
+      entries = it->second.entries;
+    }
+  }
+  if (entries) {
+    return copy_entries(*entries, allocator, names_and_types);
+  }
+
+  rcutils_allocator_t default_allocator = rcutils_get_default_allocator();
+  rmw_names_and_types_t result = rmw_get_zero_initialized_names_and_types();
+  rmw_ret_t ret = query(&default_allocator, &result);
+  if (RMW_RET_OK != ret) {
+    return ret;
+  }
+
+  try {
+    auto new_entries = std::make_shared<Entries>();
+    new_entries->reserve(result.names.size);
+    for (size_t ii = 0; ii < result.names.size; ++ii) {
+      std::vector<std::string> types;
+      types.reserve(result.types[ii].size);
+      for (size_t jj = 0; jj < result.types[ii].size; ++jj) {
+        types.emplace_back(result.types[ii].data[jj]);
+      }
+      new_entries->emplace_back(result.names.data[ii], std::move(types));
+    }
+    entries = std::move(new_entries);
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (snapshots_.size() >= max_snapshots && snapshots_.find(key) == snapshots_.end()) {
+      snapshots_.clear();
+    }
+    snapshots_[key] = Snapshot{generation, entries};
+  } catch (const std::bad_alloc &) {
+    static_cast<void>(rmw_names_and_types_fini(&result));
+    RMW_SET_ERROR_MSG("failed to allocate names and types snapshot");
+    return RMW_RET_BAD_ALLOC;
+  }
+
+  ret = rmw_names_and_types_fini(&result);
+  if (RMW_RET_OK != ret) {
+    return ret;
+  }
+  return copy_entries(*entries, allocator, names_and_types);
+}
+
+rmw_ret_t
+NamesAndTypesCache::copy_entries(
+  const Entries & entries,
+  rcutils_allocator_t * allocator,
+  rmw_names_and_types_t * names_and_types)
+{
+  if (entries.empty()) {
+    return RMW_RET_OK;
+  }
+  rmw_ret_t ret = rmw_names_and_types_init(names_and_types, entries.size(), allocator);
+  if (RMW_RET_OK != ret) {
+    return ret;
+  }
+  for (size_t ii = 0; ii < entries.size(); ++ii) {
+    const auto & name = entries[ii].first;
+    const auto & types = entries[ii].second;
+    names_and_types->names.data[ii] = rcutils_strdup(name.c_str(), *allocator);
+    if (!names_and_types->names.data[ii]) {
+      RMW_SET_ERROR_MSG("failed to allocate name");
+      ret = RMW_RET_BAD_ALLOC;
+      break;
+    }
+    ret = rmw_convert_rcutils_ret_to_rmw_ret(
+      rcutils_string_array_init(&names_and_types->types[ii], types.size(), allocator));
+    if (RMW_RET_OK != ret) {
+      break;
+    }
+    for (size_t jj = 0; jj < types.size(); ++jj) {
+      names_and_types->types[ii].data[jj] = rcutils_strdup(types[jj].c_str(), *allocator);
+      if (!names_and_types->types[ii].data[jj]) {
+        RMW_SET_ERROR_MSG("failed to allocate type");
+        ret = RMW_RET_BAD_ALLOC;
+        break;
+      }
+    }
+    if (RMW_RET_OK != ret) {
+      break;
+    }
+  }
+  if (RMW_RET_OK != ret) {
+    static_cast<void>(rmw_names_and_types_fini(names_and_types));
+  }
+  return ret;
+}
+
+}  // namespace rmw_fastrtps_shared_cpp
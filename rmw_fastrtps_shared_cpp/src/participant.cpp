@@ -13,9 +13,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdint>
+#include <limits>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "fastdds/dds/core/status/StatusMask.hpp"
@@ -41,13 +44,20 @@
 #include "rmw/allocators.h"
 
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
+#include "rmw_fastrtps_shared_cpp/loaned_message_pool.hpp"
 #include "rmw_fastrtps_shared_cpp/participant.hpp"
+#include "rmw_fastrtps_shared_cpp/response_filter.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_security_logging.hpp"
 #include "rmw_fastrtps_shared_cpp/utils.hpp"
 
 #include "rmw_dds_common/security.hpp"
 
+#include "string_utils.hpp"
+
+using rmw_fastrtps_shared_cpp::parse_integer;
+using rmw_fastrtps_shared_cpp::split;
+
 // Private function to create Participant with QoS
 static CustomParticipantInfo *
 __create_participant(
@@ -55,6 +65,11 @@ __create_participant(
   const eprosima::fastdds::dds::DomainParticipantQos & domainParticipantQos,
   bool leave_middleware_default_qos,
   publishing_mode_t publishing_mode,
+  const std::vector<std::string> & data_sharing_topics,
+  const std::vector<std::string> & borrowed_payload_topics,
+  size_t loaned_message_pool_size,
+  std::unique_ptr<FlowControlSettings> flow_control,
+  bool keyed_discovery_info,
   rmw_dds_common::Context * common_context,
   size_t domain_id)
 {
@@ -108,10 +123,25 @@ __create_participant(
     return nullptr;
   }
 
+  // Let response writers of services route each response to the client that requested it
+  if (ReturnCode_t::RETCODE_OK !=
+    participant_info->participant_->register_content_filter_factory(
+      rmw_fastrtps_shared_cpp::ResponseFilter::class_name,
+      &rmw_fastrtps_shared_cpp::ResponseFilter::get_instance()))
+  {
+    RMW_SET_ERROR_MSG("__create_participant failed to register response filter");
+    return nullptr;
+  }
+
   /////
   // Set participant info parameters
   participant_info->leave_middleware_default_qos = leave_middleware_default_qos;
   participant_info->publishing_mode = publishing_mode;
+  participant_info->data_sharing_topics = data_sharing_topics;
+  participant_info->borrowed_payload_topics = borrowed_payload_topics;
+  participant_info->loaned_message_pool_size = loaned_message_pool_size;
+  participant_info->flow_control = std::move(flow_control);
+  participant_info->keyed_discovery_info = keyed_discovery_info;
 
   /////
   // Create Publisher
@@ -142,6 +172,95 @@ __create_participant(
   return participant_info;
 }
 
+// Parse the values of env "RMW_FASTRTPS_FLOW_CONTROLLERS", a comma separated list of
+// name:max_bytes_per_period:period_ms[:scheduler], and env "RMW_FASTRTPS_FLOW_CONTROLLER_TOPICS",
+// a comma separated list of topic_pattern:name[:priority]
+static bool
+__parse_flow_control_settings(
+  const char * controllers_value,
+  const char * topics_value,
+  FlowControlSettings & settings)
+{
+  using eprosima::fastdds::rtps::FlowControllerDescriptor;
+  using eprosima::fastdds::rtps::FlowControllerSchedulerPolicy;
+
+  auto find_name = [&settings](const std::string & name) -> const char *
+    {
+      for (const std::string & existing : settings.names) {
+        if (existing == name) {
+          return existing.c_str();
+        }
+      }
+      return nullptr;
+    };
+
+  for (const std::string & controller : split(controllers_value, ',')) {
+    if (controller.empty()) {
+      continue;
+    }
+    std::vector<std::string> fields = split(controller, ':');
+    int64_t max_bytes_per_period = 0;
+    int64_t period_ms = 0;
+    if (fields.size() < 3u || fields.size() > 4u || fields[0].empty() ||
+      !parse_integer(fields[1], 1, std::numeric_limits<int32_t>::max(), max_bytes_per_period) ||
+      !parse_integer(fields[2], 1, std::numeric_limits<int32_t>::max(), period_ms))
+    {
+      RMW_SET_ERROR_MSG_WITH_FORMAT_STRING(
+        "Invalid flow controller '%s' in RMW_FASTRTPS_FLOW_CONTROLLERS", controller.c_str());
+      return false;
+    }
+    if (nullptr != find_name(fields[0])) {
+      RMW_SET_ERROR_MSG_WITH_FORMAT_STRING(
+        "Duplicated flow controller '%s' in RMW_FASTRTPS_FLOW_CONTROLLERS", fields[0].c_str());
+      return false;
+    }
+
+    auto descriptor = std::make_shared<FlowControllerDescriptor>();
+    if (fields.size() < 4u || fields[3] == "FIFO") {
+      descriptor->scheduler = FlowControllerSchedulerPolicy::FIFO;
+    } else if (fields[3] == "ROUND_ROBIN") {
+      descriptor->scheduler = FlowControllerSchedulerPolicy::ROUND_ROBIN;
+    } else if (fields[3] == "HIGH_PRIORITY") {
+      descriptor->scheduler = FlowControllerSchedulerPolicy::HIGH_PRIORITY;
+    } else if (fields[3] == "PRIORITY_WITH_RESERVATION") {
+      descriptor->scheduler = FlowControllerSchedulerPolicy::PRIORITY_WITH_RESERVATION;
+    } else {
+      RMW_SET_ERROR_MSG_WITH_FORMAT_STRING(
+        "Unknown scheduler '%s' in RMW_FASTRTPS_FLOW_CONTROLLERS", fields[3].c_str());
+      return false;
+    }
+    settings.names.push_back(fields[0]);
+    descriptor->name = settings.names.back().c_str();
+    descriptor->max_bytes_per_period = static_cast<int32_t>(max_bytes_per_period);
+    descriptor->period_ms = static_cast<uint64_t>(period_ms);
+    settings.controllers.push_back(descriptor);
+  }
+
+  for (const std::string & topic : split(topics_value, ',')) {
+    if (topic.empty()) {
+      continue;
+    }
+    std::vector<std::string> fields = split(topic, ':');
+    int64_t priority = 0;
+    if (fields.size() < 2u || fields.size() > 3u || fields[0].empty() ||
+      (fields.size() > 2u && !parse_integer(fields[2], -10, 10, priority)))
+    {
+      RMW_SET_ERROR_MSG_WITH_FORMAT_STRING(
+        "Invalid topic '%s' in RMW_FASTRTPS_FLOW_CONTROLLER_TOPICS", topic.c_str());
+      return false;
+    }
+    const char * name = find_name(fields[1]);
+    if (nullptr == name) {
+      RMW_SET_ERROR_MSG_WITH_FORMAT_STRING(
+        "Unknown flow controller '%s' in RMW_FASTRTPS_FLOW_CONTROLLER_TOPICS", fields[1].c_str());
+      return false;
+    }
+    settings.topics.push_back({fields[0], name, static_cast<int32_t>(priority)});
+  }
+
+  return true;
+}
+
 CustomParticipantInfo *
 rmw_fastrtps_shared_cpp::create_participant(
   const char * identifier,
@@ -276,6 +395,11 @@ rmw_fastrtps_shared_cpp::create_participant(
 
   bool leave_middleware_default_qos = false;
   publishing_mode_t publishing_mode = publishing_mode_t::SYNCHRONOUS;
+  std::vector<std::string> data_sharing_topics;
+  std::vector<std::string> borrowed_payload_topics;
+  size_t loaned_message_pool_size = rmw_fastrtps_shared_cpp::LoanedMessagePool::default_pool_size;
+  std::unique_ptr<FlowControlSettings> flow_control;
+  bool keyed_discovery_info = false;
   const char * env_value;
   const char * error_str;
   error_str = rcutils_get_env("RMW_FASTRTPS_USE_QOS_FROM_XML", &env_value);
@@ -286,6 +410,42 @@ rmw_fastrtps_shared_cpp::create_participant(
   if (env_value != nullptr) {
     leave_middleware_default_qos = strcmp(env_value, "1") == 0;
   }
+  error_str = rcutils_get_env("RMW_FASTRTPS_KEYED_DISCOVERY_INFO", &env_value);
+  if (error_str != NULL) {
+    RMW_SET_ERROR_MSG_WITH_FORMAT_STRING("Error getting env var: %s\n", error_str);
+    return nullptr;
+  }
+  if (env_value != nullptr) {
+    keyed_discovery_info = strcmp(env_value, "1") == 0;
+  }
+  error_str = rcutils_get_env("RMW_FASTRTPS_BORROWED_PAYLOAD_TOPICS", &env_value);
+  if (error_str != NULL) {
+    RMW_SET_ERROR_MSG_WITH_FORMAT_STRING("Error getting env var: %s\n", error_str);
+    return nullptr;
+  }
+  if (env_value != nullptr) {
+    // Comma separated list of topic name patterns
+    for (const std::string & pattern : split(env_value, ',')) {
+      if (!pattern.empty()) {
+        borrowed_payload_topics.push_back(pattern);
+      }
+    }
+  }
+  error_str = rcutils_get_env("RMW_FASTRTPS_LOANED_MESSAGE_POOL_SIZE", &env_value);
+  if (error_str != NULL) {
+    RMW_SET_ERROR_MSG_WITH_FORMAT_STRING("Error getting env var: %s\n", error_str);
+    return nullptr;
+  }
+  if (env_value != nullptr && env_value[0] != '\0') {
+    // 0 disables loaning for publishers of types which are not plain
+    int64_t pool_size = 0;
+    if (!parse_integer(env_value, 0, std::numeric_limits<int32_t>::max(), pool_size)) {
+      RMW_SET_ERROR_MSG_WITH_FORMAT_STRING(
+        "Invalid value '%s' for RMW_FASTRTPS_LOANED_MESSAGE_POOL_SIZE", env_value);
+      return nullptr;
+    }
+    loaned_message_pool_size = static_cast<size_t>(pool_size);
+  }
   if (!leave_middleware_default_qos) {
     error_str = rcutils_get_env("RMW_FASTRTPS_PUBLICATION_MODE", &env_value);
     if (error_str != NULL) {
@@ -306,6 +466,48 @@ rmw_fastrtps_shared_cpp::create_participant(
           ". Using default SYNCHRONOUS publishing mode.", env_value);
       }
     }
+
+    error_str = rcutils_get_env("RMW_FASTRTPS_DATA_SHARING_TOPICS", &env_value);
+    if (error_str != NULL) {
+      RMW_SET_ERROR_MSG_WITH_FORMAT_STRING("Error getting env var: %s\n", error_str);
+      return nullptr;
+    }
+    if (env_value != nullptr) {
+      // Comma separated list of topic name patterns
+      for (const std::string & pattern : split(env_value, ',')) {
+        if (!pattern.empty()) {
+          data_sharing_topics.push_back(pattern);
+        }
+      }
+    }
+
+    const char * flow_controllers_value = nullptr;
+    error_str = rcutils_get_env("RMW_FASTRTPS_FLOW_CONTROLLERS", &flow_controllers_value);
+    if (error_str != NULL) {
+      RMW_SET_ERROR_MSG_WITH_FORMAT_STRING("Error getting env var: %s\n", error_str);
+      return nullptr;
+    }
+    error_str = rcutils_get_env("RMW_FASTRTPS_FLOW_CONTROLLER_TOPICS", &env_value);
+    if (error_str != NULL) {
+      RMW_SET_ERROR_MSG_WITH_FORMAT_STRING("Error getting env var: %s\n", error_str);
+      return nullptr;
+    }
+    if (nullptr == flow_controllers_value) {
+      flow_controllers_value = "";
+    }
+    if (nullptr == env_value) {
+      env_value = "";
+    }
+    if ('\0' != flow_controllers_value[0] || '\0' != env_value[0]) {
+      flow_control = std::make_unique<FlowControlSettings>();
+      if (!__parse_flow_control_settings(flow_controllers_value, env_value, *flow_control)) {
+        return nullptr;
+      }
+      // The descriptors refer to names owned by flow_control, which is kept by the participant
+      for (const auto & controller : flow_control->controllers) {
+        domainParticipantQos.flow_controllers().push_back(controller);
+      }
+    }
   }
   // allow reallocation to support discovery messages bigger than 5000 bytes
   if (!leave_middleware_default_qos) {
@@ -372,6 +574,11 @@ rmw_fastrtps_shared_cpp::create_participant(
     domainParticipantQos,
     leave_middleware_default_qos,
     publishing_mode,
+    data_sharing_topics,
+    borrowed_payload_topics,
+    loaned_message_pool_size,
+    std::move(flow_control),
+    keyed_discovery_info,
     common_context,
     domain_id);
 }
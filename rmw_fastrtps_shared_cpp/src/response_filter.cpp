@@ -0,0 +1,87 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <cstring>
+
+#include "rmw_fastrtps_shared_cpp/response_filter.hpp"
+
+using ReturnCode_t = eprosima::fastrtps::types::ReturnCode_t;
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+ResponseFilter &
+ResponseFilter::get_instance()
+{
+  static ResponseFilter instance;
+  return instance;
+}
+
+ReturnCode_t
+ResponseFilter::create_content_filter(
+  const char * filter_class_name,
+  const char * type_name,
+  const eprosima::fastdds::dds::TopicDataType * data_type,
+  const char * filter_expression,
+  const ParameterSeq & filter_parameters,
+  eprosima::fastdds::dds::IContentFilter * & filter_instance)
+{
+  static_cast<void>(type_name);
+  static_cast<void>(data_type);
+  static_cast<void>(filter_expression);
+  static_cast<void>(filter_parameters);
+
+  if (0 != strcmp(filter_class_name, class_name)) {
+    return ReturnCode_t::RETCODE_BAD_PARAMETER;
+  }
+
+  // There is nothing to update when the instance already exists
+  filter_instance = this;
+  return ReturnCode_t::RETCODE_OK;
+}
+
+ReturnCode_t
+ResponseFilter::delete_content_filter(
+  const char * filter_class_name,
+  eprosima::fastdds::dds::IContentFilter * filter_instance)
+{
+  static_cast<void>(filter_class_name);
+
+  if (filter_instance != this) {
+    return ReturnCode_t::RETCODE_BAD_PARAMETER;
+  }
+  return ReturnCode_t::RETCODE_OK;
+}
+
+bool
+ResponseFilter::evaluate(
+  const SerializedPayload & payload,
+  const FilterSampleInfo & sample_info,
+  const GUID_t & reader_guid) const
+{
+  static_cast<void>(payload);
+
+  // According to the list of possible entity kinds in section 9.3.1.2 of RTPS
+  // readers will have this bit on, while writers will not.
+  constexpr uint8_t entity_id_is_reader_bit = 0x04;
+  const GUID_t & related_guid = sample_info.related_sample_identity.writer_guid();
+  if ((related_guid.entityId.value[3] & entity_id_is_reader_bit) == 0) {
+    // Related to the request writer, which cannot be mapped to a response reader here
+    return true;
+  }
+  return related_guid == reader_guid;
+}
+
+}  // namespace rmw_fastrtps_shared_cpp
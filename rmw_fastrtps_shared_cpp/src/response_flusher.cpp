@@ -0,0 +1,75 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mutex>
+#include <unordered_map>
+
+#include "rmw_fastrtps_shared_cpp/custom_service_info.hpp"
+#include "rmw_fastrtps_shared_cpp/response_flusher.hpp"
+#include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+ResponseFlusher::ResponseFlusher(
+  const char * identifier,
+  rmw_dds_common::Context * common_context)
+: identifier_(identifier),
+  common_context_(common_context)
+{
+}
+
+bool
+ResponseFlusher::schedule(
+  ServicePubListener * listener,
+  eprosima::fastdds::dds::DataWriter * writer)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  // The listener thread flushes once more after it stopped running, see node_listener()
+  if (!common_context_->thread_is_running.load()) {
+    return false;
+  }
+  if (scheduled_.emplace(listener, writer).second) {
+    static_cast<void>(
+      __rmw_trigger_guard_condition(identifier_, common_context_->listener_thread_gc));
+  }
+  return true;
+}
+
+void
+ResponseFlusher::flush()
+{
+  std::lock_guard<std::mutex> flush_guard(flush_mutex_);
+  std::unordered_map<ServicePubListener *, eprosima::fastdds::dds::DataWriter *> scheduled;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    scheduled.swap(scheduled_);
+  }
+  for (const auto & service : scheduled) {
+    service.first->flush_responses(service.second);
+  }
+}
+
+void
+ResponseFlusher::remove(ServicePubListener * listener)
+{
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    scheduled_.erase(listener);
+  }
+  // Wait for the responses of the service being written, if they are
+  std::lock_guard<std::mutex> flush_guard(flush_mutex_);
+}
+
+}  // namespace rmw_fastrtps_shared_cpp
@@ -59,11 +59,7 @@ __rmw_destroy_client(
     rmw_dds_common::msg::ParticipantEntitiesInfo msg =
       common_context->graph_cache.dissociate_reader(
       gid, common_context->gid, node->name, node->namespace_);
-    final_ret = rmw_fastrtps_shared_cpp::__rmw_publish(
-      identifier,
-      common_context->pub,
-      static_cast<void *>(&msg),
-      nullptr);
+    final_ret = node->context->impl->graph_update_publisher->publish(msg);
   }
 
   auto show_previous_error =
@@ -109,6 +105,17 @@ __rmw_destroy_client(
       delete info->pub_listener_;
     }
 
+    // Delete ContentFilteredTopic of the responses
+    if (nullptr != info->response_filtered_topic_) {
+      ret = participant_info->participant_->delete_contentfilteredtopic(
+        info->response_filtered_topic_);
+      if (ret != ReturnCode_t::RETCODE_OK) {
+        show_previous_error();
+        RMW_SET_ERROR_MSG("destroy_client() failed to delete response contentfilteredtopic");
+        final_ret = RMW_RET_ERROR;
+      }
+    }
+
     // Delete topics and unregister types
     remove_topic_and_type(
       participant_info, nullptr, info->request_topic_, info->request_type_support_);
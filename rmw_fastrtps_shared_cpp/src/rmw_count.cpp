@@ -33,9 +33,44 @@
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_context_impl.hpp"
 
+#include "name_cache.hpp"
+
 namespace rmw_fastrtps_shared_cpp
 {
 
+// Validate a topic name and mangle it, or get the result of a previous call from cache.
+// storage holds the mangled topic name when the cache is full.
+static rmw_ret_t
+__get_mangled_topic_name(
+  const char * topic_name,
+  std::string & storage,
+  const std::string * & mangled_topic_name)
+{
+  // Only valid topic names are stored
+  static NameCache cache;
+  mangled_topic_name = cache.find(topic_name);
+  if (mangled_topic_name) {
+    return RMW_RET_OK;
+  }
+
+  int validation_result = RMW_TOPIC_VALID;
+  rmw_ret_t ret = rmw_validate_full_topic_name(topic_name, &validation_result, nullptr);
+  if (RMW_RET_OK != ret) {
+    return ret;
+  }
+  if (RMW_TOPIC_VALID != validation_result) {
+    const char * reason = rmw_full_topic_name_validation_result_string(validation_result);
+    RMW_SET_ERROR_MSG_WITH_FORMAT_STRING("topic_name argument is invalid: %s", reason);
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+  storage = _mangle_topic_name(ros_topic_prefix, topic_name).to_string();
+  mangled_topic_name = cache.insert(topic_name, storage);
+  if (!mangled_topic_name) {
+    mangled_topic_name = &storage;
+  }
+  return RMW_RET_OK;
+}
+
 rmw_ret_t
 __rmw_count_publishers(
   const char * identifier,
@@ -50,21 +85,15 @@ __rmw_count_publishers(
     identifier,
     return RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
   RMW_CHECK_ARGUMENT_FOR_NULL(topic_name, RMW_RET_INVALID_ARGUMENT);
-  int validation_result = RMW_TOPIC_VALID;
-  rmw_ret_t ret = rmw_validate_full_topic_name(topic_name, &validation_result, nullptr);
+  std::string storage;
+  const std::string * mangled_topic_name = nullptr;
+  rmw_ret_t ret = __get_mangled_topic_name(topic_name, storage, mangled_topic_name);
   if (RMW_RET_OK != ret) {
     return ret;
   }
-  if (RMW_TOPIC_VALID != validation_result) {
-    const char * reason = rmw_full_topic_name_validation_result_string(validation_result);
-    RMW_SET_ERROR_MSG_WITH_FORMAT_STRING("topic_name argument is invalid: %s", reason);
-    return RMW_RET_INVALID_ARGUMENT;
-  }
   RMW_CHECK_ARGUMENT_FOR_NULL(count, RMW_RET_INVALID_ARGUMENT);
   auto common_context = static_cast<rmw_dds_common::Context *>(node->context->impl->common);
-  const std::string mangled_topic_name =
-    _mangle_topic_name(ros_topic_prefix, topic_name).to_string();
-  return common_context->graph_cache.get_writer_count(mangled_topic_name, count);
+  return common_context->graph_cache.get_writer_count(*mangled_topic_name, count);
 }
 
 rmw_ret_t
@@ -81,20 +110,14 @@ __rmw_count_subscribers(
     identifier,
     return RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
   RMW_CHECK_ARGUMENT_FOR_NULL(topic_name, RMW_RET_INVALID_ARGUMENT);
-  int validation_result = RMW_TOPIC_VALID;
-  rmw_ret_t ret = rmw_validate_full_topic_name(topic_name, &validation_result, nullptr);
+  std::string storage;
+  const std::string * mangled_topic_name = nullptr;
+  rmw_ret_t ret = __get_mangled_topic_name(topic_name, storage, mangled_topic_name);
   if (RMW_RET_OK != ret) {
     return ret;
   }
-  if (RMW_TOPIC_VALID != validation_result) {
-    const char * reason = rmw_full_topic_name_validation_result_string(validation_result);
-    RMW_SET_ERROR_MSG_WITH_FORMAT_STRING("topic_name argument is invalid: %s", reason);
-    return RMW_RET_INVALID_ARGUMENT;
-  }
   RMW_CHECK_ARGUMENT_FOR_NULL(count, RMW_RET_INVALID_ARGUMENT);
   auto common_context = static_cast<rmw_dds_common::Context *>(node->context->impl->common);
-  const std::string mangled_topic_name =
-    _mangle_topic_name(ros_topic_prefix, topic_name).to_string();
-  return common_context->graph_cache.get_reader_count(mangled_topic_name, count);
+  return common_context->graph_cache.get_reader_count(*mangled_topic_name, count);
 }
 }  // namespace rmw_fastrtps_shared_cpp
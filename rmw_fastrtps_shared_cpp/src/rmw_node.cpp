@@ -112,12 +112,7 @@ __rmw_create_node(
     std::lock_guard<std::mutex> guard(common_context->node_update_mutex);
     rmw_dds_common::msg::ParticipantEntitiesInfo participant_msg =
       graph_cache.add_node(common_context->gid, name, namespace_);
-    if (RMW_RET_OK != __rmw_publish(
-        node_handle->implementation_identifier,
-        common_context->pub,
-        static_cast<void *>(&participant_msg),
-        nullptr))
-    {
+    if (RMW_RET_OK != context->impl->graph_update_publisher->publish(participant_msg)) {
       return nullptr;
     }
   }
@@ -138,11 +133,7 @@ __rmw_destroy_node(
     std::lock_guard<std::mutex> guard(common_context->node_update_mutex);
     rmw_dds_common::msg::ParticipantEntitiesInfo participant_msg =
       graph_cache.remove_node(common_context->gid, node->name, node->namespace_);
-    ret = __rmw_publish(
-      identifier,
-      common_context->pub,
-      static_cast<void *>(&participant_msg),
-      nullptr);
+    ret = node->context->impl->graph_update_publisher->publish(participant_msg);
   }
   rmw_free(const_cast<char *>(node->name));
   rmw_free(const_cast<char *>(node->namespace_));
@@ -63,6 +63,7 @@ __rmw_get_topic_names_and_types_by_node(
   rcutils_allocator_t * allocator,
   const char * node_name,
   const char * node_namespace,
+  const char * query_name,
   DemangleFunction demangle_topic,
   DemangleFunction demangle_type,
   bool no_demangle,
@@ -108,12 +109,22 @@ __rmw_get_topic_names_and_types_by_node(
     demangle_type = _identity_demangle;
   }
 
-  return get_names_and_types_by_node(
-    common_context,
-    node_name,
-    node_namespace,
-    demangle_topic,
-    demangle_type,
+  // Node names and namespaces can not contain a space
+  std::string key = std::string(query_name) + (no_demangle ? " " : "/demangled ") +
+    node_namespace + " " + node_name;
+  return node->context->impl->names_and_types_cache.get(
+    key,
+    [&](rcutils_allocator_t * query_allocator, rmw_names_and_types_t * result) -> rmw_ret_t
+    {
+      return get_names_and_types_by_node(
+        common_context,
+        node_name,
+        node_namespace,
+        demangle_topic,
+        demangle_type,
+        query_allocator,
+        result);
+    },
     allocator,
     topic_names_and_types);
 }
@@ -172,8 +183,9 @@ __rmw_get_subscriber_names_and_types_by_node(
     allocator,
     node_name,
     node_namespace,
-    _demangle_ros_topic_from_topic,
-    _demangle_if_ros_type,
+    "subscribers",
+    _demangle_ros_topic_from_topic_cached,
+    _demangle_if_ros_type_cached,
     no_demangle,
     __get_reader_names_and_types_by_node,
     topic_names_and_types);
@@ -195,8 +207,9 @@ __rmw_get_publisher_names_and_types_by_node(
     allocator,
     node_name,
     node_namespace,
-    _demangle_ros_topic_from_topic,
-    _demangle_if_ros_type,
+    "publishers",
+    _demangle_ros_topic_from_topic_cached,
+    _demangle_if_ros_type_cached,
     no_demangle,
     __get_writer_names_and_types_by_node,
     topic_names_and_types);
@@ -217,6 +230,7 @@ __rmw_get_service_names_and_types_by_node(
     allocator,
     node_name,
     node_namespace,
+    "services",
     _demangle_service_request_from_topic,
     _demangle_service_type_only,
     false,
@@ -239,6 +253,7 @@ __rmw_get_client_names_and_types_by_node(
     allocator,
     node_name,
     node_namespace,
+    "clients",
     _demangle_service_reply_from_topic,
     _demangle_service_type_only,
     false,
@@ -18,10 +18,12 @@
 #include "rmw/allocators.h"
 #include "rmw/error_handling.h"
 #include "rmw/rmw.h"
+#include "rmw/serialized_message.h"
 #include "rmw/impl/cpp/macros.hpp"
 
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_publisher_info.hpp"
+#include "rmw_fastrtps_shared_cpp/serialized_payload_pool.hpp"
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 
 #include "tracetools/tracetools.h"
@@ -135,6 +137,25 @@ __rmw_publish_loaned_message(
   RMW_CHECK_ARGUMENT_FOR_NULL(ros_message, RMW_RET_INVALID_ARGUMENT);
 
   auto info = static_cast<CustomPublisherInfo *>(publisher->data);
+  if (info->loan_pool_) {
+    // Serialize the pooled message straight into the payload pool of the writer
+    rmw_fastrtps_shared_cpp::SerializedData data;
+    data.type = FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE;
+    data.data = const_cast<void *>(ros_message);
+    data.impl = info->type_support_impl_;
+    bool written = info->data_writer_->write(&data);
+    // The loan ends with the publication, whatever its result
+    if (!info->loan_pool_->release(const_cast<void *>(ros_message))) {
+      RMW_SET_ERROR_MSG("message was not loaned by this publisher");
+      return RMW_RET_ERROR;
+    }
+    if (!written) {
+      RMW_SET_ERROR_MSG("cannot publish data");
+      return RMW_RET_ERROR;
+    }
+    return RMW_RET_OK;
+  }
+
   if (!info->data_writer_->write(const_cast<void *>(ros_message))) {
     RMW_SET_ERROR_MSG("cannot publish data");
     return RMW_RET_ERROR;
@@ -142,4 +163,58 @@ __rmw_publish_loaned_message(
 
   return RMW_RET_OK;
 }
+
+rmw_ret_t
+__rmw_publish_borrowed_serialized_payload(
+  const char * identifier,
+  const rmw_publisher_t * publisher,
+  rmw_serialized_message_t * serialized_message,
+  rmw_publisher_allocation_t * allocation)
+{
+  static_cast<void>(allocation);
+  RMW_CHECK_ARGUMENT_FOR_NULL(publisher, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    publisher, publisher->implementation_identifier, identifier,
+    return RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
+  RMW_CHECK_ARGUMENT_FOR_NULL(serialized_message, RMW_RET_INVALID_ARGUMENT);
+
+  auto info = static_cast<CustomPublisherInfo *>(publisher->data);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(info, "publisher info pointer is null", return RMW_RET_ERROR);
+  if (!info->payload_pool_) {
+    RMW_SET_ERROR_MSG("publisher cannot lend serialized payloads");
+    return RMW_RET_UNSUPPORTED;
+  }
+  if (serialized_message->buffer_length > serialized_message->buffer_capacity) {
+    RMW_SET_ERROR_MSG("serialized message length exceeds its capacity");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+  auto & pool = *info->payload_pool_;
+  if (!pool.is_borrowed(serialized_message->buffer)) {
+    RMW_SET_ERROR_MSG("serialized payload was not borrowed from this publisher");
+    return RMW_RET_ERROR;
+  }
+
+  rmw_fastrtps_shared_cpp::SerializedData data;
+  data.type = FASTRTPS_SERIALIZED_DATA_TYPE_SERIALIZED_MESSAGE;
+  data.data = serialized_message;
+  data.impl = nullptr;  // not used when type is FASTRTPS_SERIALIZED_DATA_TYPE_SERIALIZED_MESSAGE
+
+  bool written = false;
+  {
+    // The writer takes the borrowed buffer as the payload of the sample
+    rmw_fastrtps_shared_cpp::SerializedPayloadPool::PublishScope scope(
+      pool, serialized_message->buffer);
+    written = info->data_writer_->write(&data);
+    if (!scope.buffer_taken()) {
+      pool.give_back(serialized_message->buffer);
+    }
+  }
+  *serialized_message = rmw_get_zero_initialized_serialized_message();
+
+  if (!written) {
+    RMW_SET_ERROR_MSG("cannot publish data");
+    return RMW_RET_ERROR;
+  }
+  return RMW_RET_OK;
+}
 }  // namespace rmw_fastrtps_shared_cpp
@@ -13,12 +13,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <limits>
 #include <string>
 
 #include "rmw/allocators.h"
 #include "rmw/error_handling.h"
 #include "rmw/impl/cpp/macros.hpp"
 #include "rmw/rmw.h"
+#include "rmw/serialized_message.h"
 
 #include "fastdds/dds/publisher/DataWriter.hpp"
 #include "fastdds/dds/publisher/qos/DataWriterQos.hpp"
@@ -55,11 +57,7 @@ __rmw_destroy_publisher(
     rmw_dds_common::msg::ParticipantEntitiesInfo msg =
       common_context->graph_cache.dissociate_writer(
       info->publisher_gid, common_context->gid, node->name, node->namespace_);
-    rmw_ret_t publish_ret = rmw_fastrtps_shared_cpp::__rmw_publish(
-      identifier,
-      common_context->pub,
-      &msg,
-      nullptr);
+    rmw_ret_t publish_ret = node->context->impl->graph_update_publisher->publish(msg);
     if (RMW_RET_OK != publish_ret) {
       error_state = *rmw_get_error_state();
       ret = publish_ret;
@@ -183,6 +181,15 @@ __rmw_borrow_loaned_message(
   }
 
   auto info = static_cast<CustomPublisherInfo *>(publisher->data);
+  if (info->loan_pool_) {
+    *ros_message = info->loan_pool_->borrow();
+    if (nullptr == *ros_message) {
+      RMW_SET_ERROR_MSG("failed to allocate message for loaning");
+      return RMW_RET_BAD_ALLOC;
+    }
+    return RMW_RET_OK;
+  }
+
   if (!info->data_writer_->loan_sample(*ros_message)) {
     return RMW_RET_ERROR;
   }
@@ -208,10 +215,84 @@ __rmw_return_loaned_message_from_publisher(
   RMW_CHECK_ARGUMENT_FOR_NULL(loaned_message, RMW_RET_INVALID_ARGUMENT);
 
   auto info = static_cast<CustomPublisherInfo *>(publisher->data);
+  if (info->loan_pool_) {
+    if (!info->loan_pool_->release(loaned_message)) {
+      RMW_SET_ERROR_MSG("message was not loaned by this publisher");
+      return RMW_RET_ERROR;
+    }
+    return RMW_RET_OK;
+  }
+
   if (!info->data_writer_->discard_loan(loaned_message)) {
     return RMW_RET_ERROR;
   }
 
   return RMW_RET_OK;
 }
+
+rmw_ret_t
+__rmw_borrow_serialized_payload(
+  const char * identifier,
+  const rmw_publisher_t * publisher,
+  size_t size,
+  rmw_serialized_message_t * serialized_message)
+{
+  RMW_CHECK_ARGUMENT_FOR_NULL(publisher, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    publisher, publisher->implementation_identifier, identifier,
+    return RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
+  RMW_CHECK_ARGUMENT_FOR_NULL(serialized_message, RMW_RET_INVALID_ARGUMENT);
+  if (nullptr != serialized_message->buffer) {
+    RMW_SET_ERROR_MSG("serialized message already holds a buffer");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+  if (size > std::numeric_limits<uint32_t>::max()) {
+    RMW_SET_ERROR_MSG("requested size is too big for a payload");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  auto info = static_cast<CustomPublisherInfo *>(publisher->data);
+  if (!info->payload_pool_) {
+    RMW_SET_ERROR_MSG("publisher cannot lend serialized payloads");
+    return RMW_RET_UNSUPPORTED;
+  }
+
+  uint32_t capacity = 0u;
+  auto buffer = info->payload_pool_->borrow(static_cast<uint32_t>(size), capacity);
+  if (!buffer) {
+    RMW_SET_ERROR_MSG("failed to allocate serialized payload");
+    return RMW_RET_BAD_ALLOC;
+  }
+
+  *serialized_message = rmw_get_zero_initialized_serialized_message();
+  serialized_message->buffer = buffer;
+  serialized_message->buffer_capacity = capacity;
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_return_borrowed_serialized_payload(
+  const char * identifier,
+  const rmw_publisher_t * publisher,
+  rmw_serialized_message_t * serialized_message)
+{
+  RMW_CHECK_ARGUMENT_FOR_NULL(publisher, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    publisher, publisher->implementation_identifier, identifier,
+    return RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
+  RMW_CHECK_ARGUMENT_FOR_NULL(serialized_message, RMW_RET_INVALID_ARGUMENT);
+
+  auto info = static_cast<CustomPublisherInfo *>(publisher->data);
+  if (!info->payload_pool_) {
+    RMW_SET_ERROR_MSG("publisher cannot lend serialized payloads");
+    return RMW_RET_UNSUPPORTED;
+  }
+
+  if (!info->payload_pool_->give_back(serialized_message->buffer)) {
+    RMW_SET_ERROR_MSG("serialized payload was not borrowed from this publisher");
+    return RMW_RET_ERROR;
+  }
+  *serialized_message = rmw_get_zero_initialized_serialized_message();
+  return RMW_RET_OK;
+}
 }  // namespace rmw_fastrtps_shared_cpp
@@ -14,9 +14,6 @@
 
 #include <cassert>
 
-#include "fastcdr/Cdr.h"
-#include "fastcdr/FastBuffer.h"
-
 #include "fastdds/rtps/common/WriteParams.h"
 #include "fastdds/dds/core/StackAllocatedSequence.hpp"
 
@@ -94,58 +91,48 @@ __rmw_take_request(
 
   CustomServiceRequest request;
 
-  request.buffer_ = new eprosima::fastcdr::FastBuffer();
-
-  if (request.buffer_ != nullptr) {
-    rmw_fastrtps_shared_cpp::SerializedData data;
-    data.type = FASTRTPS_SERIALIZED_DATA_TYPE_CDR_BUFFER;
-    data.data = request.buffer_;
-    data.impl = nullptr;  // not used when type is FASTRTPS_SERIALIZED_DATA_TYPE_CDR_BUFFER
-
-    eprosima::fastdds::dds::StackAllocatedSequence<void *, 1> data_values;
-    const_cast<void **>(data_values.buffer())[0] = &data;
-    eprosima::fastdds::dds::SampleInfoSeq info_seq{1};
-
-    if (ReturnCode_t::RETCODE_OK == info->request_reader_->take(data_values, info_seq, 1)) {
-      if (info_seq[0].valid_data) {
-        request.sample_identity_ = info_seq[0].sample_identity;
-        // Use response subscriber guid (on related_sample_identity) when present.
-        const eprosima::fastrtps::rtps::GUID_t & reader_guid =
-          info_seq[0].related_sample_identity.writer_guid();
-        if (reader_guid != eprosima::fastrtps::rtps::GUID_t::unknown()) {
-          request.sample_identity_.writer_guid() = reader_guid;
-        }
-
-        // Save both guids in the clients_endpoints map
-        const eprosima::fastrtps::rtps::GUID_t & writer_guid =
-          info_seq[0].sample_identity.writer_guid();
-        info->pub_listener_->endpoint_add_reader_and_writer(reader_guid, writer_guid);
-
-        auto raw_type_support = dynamic_cast<rmw_fastrtps_shared_cpp::TypeSupport *>(
-          info->response_type_support_.get());
-        eprosima::fastcdr::Cdr deser(*request.buffer_, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN,
-          eprosima::fastcdr::Cdr::DDS_CDR);
-        if (raw_type_support->deserializeROSmessage(
-            deser, ros_request, info->request_type_support_impl_))
-        {
-          // Get header
-          rmw_fastrtps_shared_cpp::copy_from_fastrtps_guid_to_byte_array(
-            request.sample_identity_.writer_guid(),
-            request_header->request_id.writer_guid);
-          request_header->request_id.sequence_number =
-            ((int64_t)request.sample_identity_.sequence_number().high) <<
-            32 | request.sample_identity_.sequence_number().low;
-          request_header->source_timestamp = info_seq[0].source_timestamp.to_ns();
-          request_header->received_timestamp = info_seq[0].source_timestamp.to_ns();
-          *taken = true;
-        }
+  // Deserialize straight from the payload into ros_request
+  rmw_fastrtps_shared_cpp::SerializedData data;
+  data.type = FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE;
+  data.data = ros_request;
+  data.impl = info->request_type_support_impl_;
+
+  eprosima::fastdds::dds::StackAllocatedSequence<void *, 1> data_values;
+  const_cast<void **>(data_values.buffer())[0] = &data;
+  eprosima::fastdds::dds::SampleInfoSeq info_seq{1};
+
+  if (ReturnCode_t::RETCODE_OK ==
+    info->ready_counter_.take(info->request_reader_, data_values, info_seq, 1))
+  {
+    // The info->request_reader_->take() call already modified the ros_request arg
+    // See rmw_fastrtps_shared_cpp/src/TypeSupport_impl.cpp
+    if (info_seq[0].valid_data) {
+      request.sample_identity_ = info_seq[0].sample_identity;
+      // Use response subscriber guid (on related_sample_identity) when present.
+      const eprosima::fastrtps::rtps::GUID_t & reader_guid =
+        info_seq[0].related_sample_identity.writer_guid();
+      if (reader_guid != eprosima::fastrtps::rtps::GUID_t::unknown()) {
+        request.sample_identity_.writer_guid() = reader_guid;
       }
-    }
 
-    delete request.buffer_;
+      // Save both guids in the clients_endpoints map
+      const eprosima::fastrtps::rtps::GUID_t & writer_guid =
+        info_seq[0].sample_identity.writer_guid();
+      info->pub_listener_->endpoint_add_reader_and_writer(reader_guid, writer_guid);
+
+      // Get header
+      rmw_fastrtps_shared_cpp::copy_from_fastrtps_guid_to_byte_array(
+        request.sample_identity_.writer_guid(),
+        request_header->request_id.writer_guid);
+      request_header->request_id.sequence_number =
+        ((int64_t)request.sample_identity_.sequence_number().high) <<
+        32 | request.sample_identity_.sequence_number().low;
+      request_header->source_timestamp = info_seq[0].source_timestamp.to_ns();
+      request_header->received_timestamp = info_seq[0].source_timestamp.to_ns();
+      *taken = true;
+    }
   }
 
-
   return RMW_RET_OK;
 }
 
@@ -13,12 +13,16 @@
 // limitations under the License.
 
 #include <cassert>
+#include <utility>
 
 #include "fastcdr/Cdr.h"
 
+#include "fastdds/rtps/common/SerializedPayload.h"
 #include "fastdds/rtps/common/WriteParams.h"
 #include "fastdds/dds/core/StackAllocatedSequence.hpp"
 
+#include "rcpputils/scope_exit.hpp"
+
 #include "rmw/error_handling.h"
 #include "rmw/rmw.h"
 #include "rmw/impl/cpp/macros.hpp"
@@ -53,50 +57,79 @@ __rmw_take_response(
   auto info = static_cast<CustomClientInfo *>(client->data);
   assert(info);
 
-  CustomClientResponse response;
-
-  // Todo(sloretz) eliminate heap allocation pending eprosima/Fast-CDR#19
-  response.buffer_.reset(new eprosima::fastcdr::FastBuffer());
   rmw_fastrtps_shared_cpp::SerializedData data;
-  data.type = FASTRTPS_SERIALIZED_DATA_TYPE_CDR_BUFFER;
-  data.data = response.buffer_.get();
-  data.impl = nullptr;  // not used when type is FASTRTPS_SERIALIZED_DATA_TYPE_CDR_BUFFER
+  data.type = FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE;
+  data.data = ros_response;
+  data.impl = info->response_type_support_impl_;
 
   eprosima::fastdds::dds::StackAllocatedSequence<void *, 1> data_values;
   const_cast<void **>(data_values.buffer())[0] = &data;
   eprosima::fastdds::dds::SampleInfoSeq info_seq{1};
 
-  if (ReturnCode_t::RETCODE_OK == info->response_reader_->take(data_values, info_seq, 1)) {
-    if (info_seq[0].valid_data) {
-      response.sample_identity_ = info_seq[0].related_sample_identity;
-
-      if (response.sample_identity_.writer_guid() == info->reader_guid_ ||
-        response.sample_identity_.writer_guid() == info->writer_guid_)
+  // Responses to other clients are normally filtered out by the response filter, but the ones
+  // related to a request writer reach every client. They are only known once taken, so they
+  // are deserialized into ros_response too, and skipped.
+  while (ReturnCode_t::RETCODE_OK ==
+    info->ready_counter_.take(info->response_reader_, data_values, info_seq, 1))
+  {
+    auto reset = rcpputils::make_scope_exit(
+      [&]()
       {
-        auto raw_type_support = dynamic_cast<rmw_fastrtps_shared_cpp::TypeSupport *>(
-          info->response_type_support_.get());
-        eprosima::fastcdr::Cdr deser(
-          *response.buffer_,
-          eprosima::fastcdr::Cdr::DEFAULT_ENDIAN,
-          eprosima::fastcdr::Cdr::DDS_CDR);
-        if (raw_type_support->deserializeROSmessage(
-            deser, ros_response, info->response_type_support_impl_))
-        {
-          request_header->source_timestamp = info_seq[0].source_timestamp.to_ns();
-          request_header->received_timestamp = info_seq[0].reception_timestamp.to_ns();
-          request_header->request_id.sequence_number =
-            ((int64_t)response.sample_identity_.sequence_number().high) <<
-            32 | response.sample_identity_.sequence_number().low;
-
-          *taken = true;
-        }
-      }
+        data_values.length(0);
+        info_seq.length(0);
+      });
+
+    if (!info_seq[0].valid_data) {
+      continue;
+    }
+    const eprosima::fastrtps::rtps::SampleIdentity & identity =
+      info_seq[0].related_sample_identity;
+    const eprosima::fastrtps::rtps::GUID_t & related_guid = identity.writer_guid();
+    if (related_guid != info->reader_guid_ && related_guid != info->writer_guid_) {
+      continue;
     }
+
+    // The info->response_reader_->take() call already modified the ros_response arg
+    // See rmw_fastrtps_shared_cpp/src/TypeSupport_impl.cpp
+    request_header->source_timestamp = info_seq[0].source_timestamp.to_ns();
+    request_header->received_timestamp = info_seq[0].reception_timestamp.to_ns();
+    request_header->request_id.sequence_number =
+      ((int64_t)identity.sequence_number().high) <<
+      32 | identity.sequence_number().low;
+
+    *taken = true;
+    break;
   }
 
   return RMW_RET_OK;
 }
 
+// Serialize a response and keep it until the response reader of the client is matched.
+// Returns the result of ServicePubListener::defer_response(), or FAILURE on serialization errors.
+static client_present_t
+__defer_response(
+  CustomServiceInfo * info,
+  const eprosima::fastrtps::rtps::GUID_t & reader_guid,
+  const eprosima::fastrtps::rtps::WriteParams & wparams,
+  rmw_fastrtps_shared_cpp::SerializedData & data)
+{
+  eprosima::fastrtps::rtps::SerializedPayload_t payload(
+    info->response_type_support_->getSerializedSizeProvider(&data)());
+  if (!info->response_type_support_->serialize(&data, &payload)) {
+    RMW_SET_ERROR_MSG("cannot serialize response");
+    return client_present_t::FAILURE;
+  }
+
+  DeferredResponse response;
+  response.wparams = wparams;
+  response.payload.assign(payload.data, payload.data + payload.length);
+  client_present_t ret = info->pub_listener_->defer_response(reader_guid, std::move(response));
+  if (ret == client_present_t::FAILURE) {
+    RMW_SET_ERROR_MSG("client will not receive response");
+  }
+  return ret;
+}
+
 rmw_ret_t
 __rmw_send_response(
   const char * identifier,
@@ -126,10 +159,15 @@ __rmw_send_response(
   wparams.related_sample_identity().sequence_number().low =
     (int32_t)(request_header->sequence_number & 0xFFFFFFFF);
 
+  rmw_fastrtps_shared_cpp::SerializedData data;
+  data.type = FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE;
+  data.data = const_cast<void *>(ros_response);
+  data.impl = info->response_type_support_impl_;
+
   // TODO(MiguelCompany) The following block is a workaround for the race on the
   // discovery of services. It is (ab)using a related_sample_identity on the request
-  // with the GUID of the response reader, so we can wait here for it to be matched to
-  // the server response writer. In the future, this should be done with the mechanism
+  // with the GUID of the response reader, so we can hold the response until it is matched
+  // to the server response writer. In the future, this should be done with the mechanism
   // explained on OMG DDS-RPC 1.0 spec under section 7.6.2 (Enhanced Service Mapping)
 
   // According to the list of possible entity kinds in section 9.3.1.2 of RTPS
@@ -140,21 +178,24 @@ __rmw_send_response(
     wparams.related_sample_identity().writer_guid();
   if ((related_guid.entityId.value[3] & entity_id_is_reader_bit) != 0) {
     // Related guid is a reader, so it is the response subscription guid.
-    // Wait for the response writer to be matched with it.
+    // Until it is matched to the response writer, the response is kept by the listener of the
+    // writer, and written by the first flush after the match, so this thread does not wait
+    // for it.
     auto listener = info->pub_listener_;
     client_present_t ret = listener->check_for_subscription(related_guid);
-    if (ret == client_present_t::GONE) {
+    if (ret == client_present_t::MAYBE) {
+      ret = __defer_response(info, related_guid, wparams, data);
+    }
+    if (ret == client_present_t::GONE || ret == client_present_t::MAYBE) {
       return RMW_RET_OK;
-    } else if (ret == client_present_t::MAYBE) {
-      RMW_SET_ERROR_MSG("client will not receive response");
-      return RMW_RET_TIMEOUT;
+    } else if (ret == client_present_t::FAILURE) {
+      return RMW_RET_ERROR;
     }
   }
 
-  rmw_fastrtps_shared_cpp::SerializedData data;
-  data.type = FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE;
-  data.data = const_cast<void *>(ros_response);
-  data.impl = info->response_type_support_impl_;
+  // Responses parked for the client, if any, go first
+  info->pub_listener_->flush_responses(info->response_writer_);
+
   if (info->response_writer_->write(&data, wparams)) {
     returnedValue = RMW_RET_OK;
   } else {
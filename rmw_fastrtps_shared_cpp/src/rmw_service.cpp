@@ -71,11 +71,7 @@ __rmw_destroy_service(
     rmw_dds_common::msg::ParticipantEntitiesInfo msg =
       common_context->graph_cache.dissociate_writer(
       gid, common_context->gid, node->name, node->namespace_);
-    final_ret = rmw_fastrtps_shared_cpp::__rmw_publish(
-      identifier,
-      common_context->pub,
-      static_cast<void *>(&msg),
-      nullptr);
+    final_ret = node->context->impl->graph_update_publisher->publish(msg);
   }
 
   auto show_previous_error =
@@ -108,6 +104,11 @@ __rmw_destroy_service(
       info->listener_ = nullptr;
     }
 
+    // The parked responses are not written anymore
+    if (nullptr != info->pub_listener_) {
+      info->pub_listener_->detach_flusher();
+    }
+
     // Delete DataWriter
     ret = participant_info->publisher_->delete_datawriter(info->response_writer_);
     if (ret != ReturnCode_t::RETCODE_OK) {
@@ -55,9 +55,16 @@ __rmw_get_service_names_and_types(
 
   auto common_context = static_cast<rmw_dds_common::Context *>(node->context->impl->common);
 
-  return common_context->graph_cache.get_names_and_types(
-    _demangle_service_from_topic,
-    _demangle_service_type_only,
+  return node->context->impl->names_and_types_cache.get(
+    "services",
+    [&](rcutils_allocator_t * query_allocator, rmw_names_and_types_t * result) -> rmw_ret_t
+    {
+      return common_context->graph_cache.get_names_and_types(
+        _demangle_service_from_topic,
+        _demangle_service_type_only,
+        query_allocator,
+        result);
+    },
     allocator,
     service_names_and_types);
 }
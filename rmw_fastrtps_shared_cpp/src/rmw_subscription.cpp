@@ -58,11 +58,7 @@ __rmw_destroy_subscription(
     rmw_dds_common::msg::ParticipantEntitiesInfo msg =
       common_context->graph_cache.dissociate_reader(
       info->subscription_gid_, common_context->gid, node->name, node->namespace_);
-    ret = rmw_fastrtps_shared_cpp::__rmw_publish(
-      identifier,
-      common_context->pub,
-      static_cast<void *>(&msg),
-      nullptr);
+    ret = node->context->impl->graph_update_publisher->publish(msg);
     if (RMW_RET_OK != ret) {
       error_state = *rmw_get_error_state();
       error_string = rmw_get_error_string();
@@ -215,11 +211,7 @@ __rmw_subscription_set_content_filter(
     rmw_dds_common::msg::ParticipantEntitiesInfo msg =
       common_context->graph_cache.associate_reader(
       info->subscription_gid_, common_context->gid, node->name, node->namespace_);
-    rmw_ret_t rmw_ret = rmw_fastrtps_shared_cpp::__rmw_publish(
-      eprosima_fastrtps_identifier,
-      common_context->pub,
-      static_cast<void *>(&msg),
-      nullptr);
+    rmw_ret_t rmw_ret = node->context->impl->graph_update_publisher->publish(msg);
     if (RMW_RET_OK != rmw_ret) {
       static_cast<void>(common_context->graph_cache.dissociate_reader(
         info->subscription_gid_, common_context->gid, node->name, node->namespace_));
@@ -12,8 +12,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <utility>
+#include <vector>
 
 #include "rmw/allocators.h"
 #include "rmw/error_handling.h"
@@ -23,10 +30,7 @@
 #include "fastdds/dds/subscriber/SampleInfo.hpp"
 #include "fastdds/dds/core/StackAllocatedSequence.hpp"
 
-#include "fastrtps/utils/collections/ResourceLimitedVector.hpp"
-
-#include "fastcdr/Cdr.h"
-#include "fastcdr/FastBuffer.h"
+#include "fastrtps/utils/collections/ResourceLimitedContainerConfig.hpp"
 
 #include "rmw_fastrtps_shared_cpp/custom_subscriber_info.hpp"
 #include "rmw_fastrtps_shared_cpp/guid_utils.hpp"
@@ -34,6 +38,7 @@
 #include "rmw_fastrtps_shared_cpp/subscription.hpp"
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 #include "rmw_fastrtps_shared_cpp/utils.hpp"
+#include "types/serialized_data_sequence.hpp"
 
 #include "rosidl_dynamic_typesupport/types.h"
 
@@ -66,28 +71,31 @@ _assign_message_info(
     sender_gid->data);
 }
 
-rmw_ret_t
-_take(
-  const char * identifier,
-  const rmw_subscription_t * subscription,
-  void * ros_message,
-  bool * taken,
-  rmw_message_info_t * message_info,
-  rmw_subscription_allocation_t * allocation)
+// Whether a sample has been published by a writer of the participant of the reader
+static bool
+_is_local_publication(
+  const CustomSubscriberInfo * info,
+  const eprosima::fastdds::dds::SampleInfo & sample_info)
 {
-  (void) allocation;
-  *taken = false;
-
-  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
-    subscription handle,
-    subscription->implementation_identifier, identifier,
-    return RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
+  auto sample_writer_guid =
+    eprosima::fastrtps::rtps::iHandle2GUID(sample_info.publication_handle);
+  return sample_writer_guid.guidPrefix == info->data_reader_->guid().guidPrefix;
+}
 
-  auto info = static_cast<CustomSubscriberInfo *>(subscription->data);
-  RCUTILS_CHECK_FOR_NULL_WITH_MSG(info, "custom subscriber info is null", return RMW_RET_ERROR);
+// Take the next sample of a subscription ignoring local publications which is not a local
+// publication, deserializing it into ros_message and storing its info in sample_info.
+// The writer of the first untaken sample is checked before taking it, so local publications are
+// dropped without being deserialized, and the other samples are deserialized straight from
+// their payload.
+static bool
+_take_ignoring_local_publications(
+  CustomSubscriberInfo * info,
+  void * ros_message,
+  eprosima::fastdds::dds::SampleInfo & sample_info)
+{
+  std::lock_guard<std::mutex> lock(info->ignore_local_take_mutex_);
 
   rmw_fastrtps_shared_cpp::SerializedData data;
-  data.type = FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE;
   data.data = ros_message;
   data.impl = info->type_support_impl_;
 
@@ -95,9 +103,20 @@ _take(
   const_cast<void **>(data_values.buffer())[0] = &data;
   eprosima::fastdds::dds::SampleInfoSeq info_seq{1};
 
-  while (ReturnCode_t::RETCODE_OK == info->data_reader_->take(data_values, info_seq, 1)) {
-    // The info->data_reader_->take() call already modified the ros_message arg
-    // See rmw_fastrtps_shared_cpp/src/TypeSupport_impl.cpp
+  eprosima::fastdds::dds::SampleInfo first_info;
+  while (ReturnCode_t::RETCODE_OK == info->data_reader_->get_first_untaken_info(&first_info)) {
+    const bool is_ignored = _is_local_publication(info, first_info);
+    data.type = is_ignored ?
+      FASTRTPS_SERIALIZED_DATA_TYPE_DISCARD : FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE;
+
+    ReturnCode_t ret = info->ready_counter_.take(info->data_reader_, data_values, info_seq, 1);
+    if (ReturnCode_t::RETCODE_NO_DATA == ret) {
+      // The sample could not be deserialized, and has been dropped
+      continue;
+    }
+    if (ReturnCode_t::RETCODE_OK != ret) {
+      break;
+    }
 
     auto reset = rcpputils::make_scope_exit(
       [&]()
@@ -106,22 +125,73 @@ _take(
         info_seq.length(0);
       });
 
-    if (subscription->options.ignore_local_publications) {
-      auto sample_writer_guid =
-        eprosima::fastrtps::rtps::iHandle2GUID(info_seq[0].publication_handle);
-
-      if (sample_writer_guid.guidPrefix == info->data_reader_->guid().guidPrefix) {
-        // This is a local publication. Ignore it
-        continue;
-      }
+    if (!is_ignored && info_seq[0].valid_data) {
+      sample_info = info_seq[0];
+      return true;
     }
+  }
 
-    if (info_seq[0].valid_data) {
+  return false;
+}
+
+rmw_ret_t
+_take(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  void * ros_message,
+  bool * taken,
+  rmw_message_info_t * message_info,
+  rmw_subscription_allocation_t * allocation)
+{
+  (void) allocation;
+  *taken = false;
+
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    subscription handle,
+    subscription->implementation_identifier, identifier,
+    return RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
+
+  auto info = static_cast<CustomSubscriberInfo *>(subscription->data);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(info, "custom subscriber info is null", return RMW_RET_ERROR);
+
+  if (subscription->options.ignore_local_publications) {
+    eprosima::fastdds::dds::SampleInfo sample_info;
+    if (_take_ignoring_local_publications(info, ros_message, sample_info)) {
       if (message_info) {
-        _assign_message_info(identifier, message_info, &info_seq[0]);
+        _assign_message_info(identifier, message_info, &sample_info);
       }
       *taken = true;
-      break;
+    }
+  } else {
+    rmw_fastrtps_shared_cpp::SerializedData data;
+    data.type = FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE;
+    data.data = ros_message;
+    data.impl = info->type_support_impl_;
+
+    eprosima::fastdds::dds::StackAllocatedSequence<void *, 1> data_values;
+    const_cast<void **>(data_values.buffer())[0] = &data;
+    eprosima::fastdds::dds::SampleInfoSeq info_seq{1};
+
+    while (ReturnCode_t::RETCODE_OK ==
+      info->ready_counter_.take(info->data_reader_, data_values, info_seq, 1))
+    {
+      // The info->data_reader_->take() call already modified the ros_message arg
+      // See rmw_fastrtps_shared_cpp/src/TypeSupport_impl.cpp
+
+      auto reset = rcpputils::make_scope_exit(
+        [&]()
+        {
+          data_values.length(0);
+          info_seq.length(0);
+        });
+
+      if (info_seq[0].valid_data) {
+        if (message_info) {
+          _assign_message_info(identifier, message_info, &info_seq[0]);
+        }
+        *taken = true;
+        break;
+      }
     }
   }
 
@@ -145,8 +215,6 @@ _take_sequence(
   rmw_subscription_allocation_t * allocation)
 {
   *taken = 0;
-  bool taken_flag = false;
-  rmw_ret_t ret = RMW_RET_OK;
 
   RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
     subscription handle,
@@ -156,25 +224,92 @@ _take_sequence(
   auto info = static_cast<CustomSubscriberInfo *>(subscription->data);
   RCUTILS_CHECK_FOR_NULL_WITH_MSG(info, "custom subscriber info is null", return RMW_RET_ERROR);
 
-  for (size_t ii = 0; ii < count; ++ii) {
-    taken_flag = false;
-    ret = _take(
-      identifier, subscription, message_sequence->data[*taken],
-      &taken_flag, &message_info_sequence->data[*taken], allocation);
-
-    if (ret != RMW_RET_OK) {
-      break;
+  if (subscription->options.ignore_local_publications) {
+    // Local publications are only known once taken, and would leave gaps in a batch, so they
+    // are skipped one sample at a time
+    while (*taken < count) {
+      bool taken_one = false;
+      rmw_ret_t ret = _take(
+        identifier, subscription, message_sequence->data[*taken], &taken_one,
+        &message_info_sequence->data[*taken], allocation);
+      if (RMW_RET_OK != ret || !taken_one) {
+        break;
+      }
+      (*taken)++;
     }
+  } else {
+    // Samples are taken in batches, so the reader is only locked once per batch instead of once
+    // per sample. Valid samples are deserialized in order into the next messages of
+    // message_sequence, without allocating.
+    constexpr size_t max_batch_size = 32u;
+    RosMessageCursor cursor;
+    rmw_fastrtps_shared_cpp::SerializedData data;
+    data.type = FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE_CURSOR;
+    data.data = &cursor;
+    data.impl = info->type_support_impl_;
+    void * data_pointers[max_batch_size];
+    std::fill(std::begin(data_pointers), std::end(data_pointers), &data);
+    thread_local eprosima::fastdds::dds::SampleInfoSeq info_seq{
+      static_cast<eprosima::fastdds::dds::LoanableCollection::size_type>(max_batch_size)};
+
+    while (*taken < count) {
+      const size_t batch_size = (std::min)(count - *taken, max_batch_size);
+      cursor.messages = &message_sequence->data[*taken];
+      cursor.count = batch_size;
+      cursor.next = 0u;
+
+      // Fast DDS requires both collections to have the same maximum, so the number of samples
+      // of a smaller batch is only limited by max_samples
+      SerializedDataSequence data_values(data_pointers, info_seq.maximum());
+      const auto max_samples = static_cast<int32_t>(batch_size);
+      ReturnCode_t ret = info->ready_counter_.take(
+        info->data_reader_, data_values, info_seq, max_samples);
+      if (ReturnCode_t::RETCODE_NO_DATA == ret) {
+        break;
+      }
+      if (ReturnCode_t::RETCODE_OK != ret) {
+        RMW_SET_ERROR_MSG("failed to take a sequence of messages");
+        message_sequence->size = *taken;
+        message_info_sequence->size = *taken;
+        return rmw_fastrtps_shared_cpp::cast_error_dds_to_rmw(ret);
+      }
 
-    if (taken_flag) {
-      (*taken)++;
+      const size_t received = static_cast<size_t>(info_seq.length());
+      for (size_t ii = 0; ii < received; ++ii) {
+        if (!info_seq[ii].valid_data) {
+          continue;
+        }
+
+        // The info->data_reader_->take() call already deserialized the sample into
+        // message_sequence->data[*taken]
+        // See rmw_fastrtps_shared_cpp/src/TypeSupport_impl.cpp
+        _assign_message_info(identifier, &message_info_sequence->data[*taken], &info_seq[ii]);
+
+        TRACEPOINT(
+          rmw_take,
+          static_cast<const void *>(subscription),
+          static_cast<const void *>(message_sequence->data[*taken]),
+          message_info_sequence->data[*taken].source_timestamp,
+          true);
+
+        (*taken)++;
+      }
+      assert(message_sequence->data + *taken == cursor.messages + cursor.next);
+
+      data_values.length(0);
+      info_seq.length(0);
+
+      if (received < batch_size) {
+        // The reader has been drained
+        break;
+      }
     }
   }
 
   message_sequence->size = *taken;
   message_info_sequence->size = *taken;
 
-  return ret;
+  return RMW_RET_OK;
 }
 
 rmw_ret_t
@@ -311,18 +446,19 @@ _take_serialized_message(
   auto info = static_cast<CustomSubscriberInfo *>(subscription->data);
   RCUTILS_CHECK_FOR_NULL_WITH_MSG(info, "custom subscriber info is null", return RMW_RET_ERROR);
 
-  eprosima::fastcdr::FastBuffer buffer;
-
+  // The payload is copied straight into serialized_message, which is grown when needed
   rmw_fastrtps_shared_cpp::SerializedData data;
-  data.type = FASTRTPS_SERIALIZED_DATA_TYPE_CDR_BUFFER;
-  data.data = &buffer;
-  data.impl = nullptr;  // not used when type is FASTRTPS_SERIALIZED_DATA_TYPE_CDR_BUFFER
+  data.type = FASTRTPS_SERIALIZED_DATA_TYPE_SERIALIZED_MESSAGE;
+  data.data = serialized_message;
+  data.impl = nullptr;  // not used when type is FASTRTPS_SERIALIZED_DATA_TYPE_SERIALIZED_MESSAGE
 
   eprosima::fastdds::dds::StackAllocatedSequence<void *, 1> data_values;
   const_cast<void **>(data_values.buffer())[0] = &data;
   eprosima::fastdds::dds::SampleInfoSeq info_seq{1};
 
-  while (ReturnCode_t::RETCODE_OK == info->data_reader_->take(data_values, info_seq, 1)) {
+  while (ReturnCode_t::RETCODE_OK ==
+    info->ready_counter_.take(info->data_reader_, data_values, info_seq, 1))
+  {
     auto reset = rcpputils::make_scope_exit(
       [&]()
       {
@@ -331,16 +467,6 @@ _take_serialized_message(
       });
 
     if (info_seq[0].valid_data) {
-      auto buffer_size = static_cast<size_t>(buffer.getBufferSize());
-      if (serialized_message->buffer_capacity < buffer_size) {
-        auto ret = rmw_serialized_message_resize(serialized_message, buffer_size);
-        if (ret != RMW_RET_OK) {
-          return ret;           // Error message already set
-        }
-      }
-      serialized_message->buffer_length = buffer_size;
-      memcpy(serialized_message->buffer, buffer.getBuffer(), serialized_message->buffer_length);
-
       if (message_info) {
         _assign_message_info(identifier, message_info, &info_seq[0]);
       }
@@ -418,8 +544,6 @@ _take_dynamic_message(
   auto info = static_cast<CustomSubscriberInfo *>(subscription->data);
   RCUTILS_CHECK_FOR_NULL_WITH_MSG(info, "custom subscriber info is null", return RMW_RET_ERROR);
 
-  eprosima::fastcdr::FastBuffer buffer;
-
   rmw_fastrtps_shared_cpp::SerializedData data;
   data.type = FASTRTPS_SERIALIZED_DATA_TYPE_DYNAMIC_MESSAGE;
   data.data = dynamic_data->impl.handle;
@@ -429,7 +553,9 @@ _take_dynamic_message(
   const_cast<void **>(data_values.buffer())[0] = &data;
   eprosima::fastdds::dds::SampleInfoSeq info_seq{1};
 
-  while (ReturnCode_t::RETCODE_OK == info->data_reader_->take(data_values, info_seq, 1)) {
+  while (ReturnCode_t::RETCODE_OK ==
+    info->ready_counter_.take(info->data_reader_, data_values, info_seq, 1))
+  {
     // The info->data_reader_->take() call already modified the dynamic_data arg
     // See rmw_fastrtps_shared_cpp/src/TypeSupport_impl.cpp
 
@@ -512,48 +638,144 @@ struct GenericSequence : public eprosima::fastdds::dds::LoanableCollection
   }
 };
 
+// Bookkeeping of the loans taken from the DataReader of a subscription.
+// Items are preallocated from outstanding_reads_allocation and reused, so taking a loan does not
+// allocate, and the item holding a loaned message is found through an open addressing table
+// indexed by the address of the message.
 struct LoanManager
 {
   struct Item
   {
     GenericSequence data_seq{};
     eprosima::fastdds::dds::SampleInfoSeq info_seq{};
+    // The loaned message, or the first message of a loaned sequence, while the item is in the
+    // loans table
+    void * message{nullptr};
   };
 
   explicit LoanManager(
     const eprosima::fastrtps::ResourceLimitedContainerConfig & items_cfg)
-  : items(items_cfg)
+  : max_items((std::max)(items_cfg.maximum, static_cast<size_t>(1u))),
+    increment((std::max)(items_cfg.increment, static_cast<size_t>(1u)))
   {
+    std::lock_guard<std::mutex> guard(mtx);
+    grow((std::min)((std::max)(items_cfg.initial, static_cast<size_t>(1u)), max_items));
   }
 
-  void add_item(
-    std::unique_ptr<Item> item)
+  // Get an unused item to take into.
+  // Returns nullptr when max_items are already in use.
+  Item * acquire_item()
   {
     std::lock_guard<std::mutex> guard(mtx);
-    items.push_back(std::move(item));
+    if (free_items.empty()) {
+      if (items.size() >= max_items) {
+        return nullptr;
+      }
+      grow((std::min)(increment, max_items - items.size()));
+    }
+    Item * item = free_items.back();
+    free_items.pop_back();
+    return item;
   }
 
-  std::unique_ptr<Item> erase_item(
+  // Give back an item which does not hold a loan
+  void release_item(
+    Item * item)
+  {
+    std::lock_guard<std::mutex> guard(mtx);
+    free_items.push_back(item);
+  }
+
+  void add_item(
+    Item * item,
     void * loaned_message)
   {
-    std::unique_ptr<Item> ret{nullptr};
+    item->message = loaned_message;
 
     std::lock_guard<std::mutex> guard(mtx);
-    for (auto it = items.begin(); it != items.end(); ++it) {
-      if (loaned_message == (*it)->data_seq.buffer()[0]) {
-        ret = std::move(*it);
-        items.erase(it);
-        break;
+    size_t index = home_slot(loaned_message);
+    while (nullptr != loans[index]) {
+      index = (index + 1) & loans_mask;
+    }
+    loans[index] = item;
+  }
+
+  Item * erase_item(
+    void * loaned_message)
+  {
+    std::lock_guard<std::mutex> guard(mtx);
+    size_t index = home_slot(loaned_message);
+    while (nullptr != loans[index] && loaned_message != loans[index]->message) {
+      index = (index + 1) & loans_mask;
+    }
+    Item * ret = loans[index];
+    if (nullptr == ret) {
+      return nullptr;
+    }
+
+    // Move back the entries following the erased one which would not be found otherwise
+    loans[index] = nullptr;
+    size_t next = index;
+    while (nullptr != loans[next = (next + 1) & loans_mask]) {
+      size_t home = home_slot(loans[next]->message);
+      if (((next - home) & loans_mask) >= ((next - index) & loans_mask)) {
+        loans[index] = loans[next];
+        loans[next] = nullptr;
+        index = next;
       }
     }
 
+    ret->message = nullptr;
     return ret;
   }
 
 private:
+  size_t home_slot(
+    const void * message) const RCPPUTILS_TSA_REQUIRES(mtx)
+  {
+    // Fibonacci hashing, as messages are usually allocated at regular intervals
+    uint64_t key = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(message));
+    return static_cast<size_t>((key * 11400714819323198485ull) >> 32) & loans_mask;
+  }
+
+  void grow(
+    size_t count) RCPPUTILS_TSA_REQUIRES(mtx)
+  {
+    for (size_t i = 0; i < count; ++i) {
+      items.push_back(std::make_unique<Item>());
+      free_items.push_back(items.back().get());
+    }
+
+    // Keep the table at most half full, rehashing the current loans when it has to be enlarged
+    size_t table_size = 2u;
+    while (table_size < 2u * items.size()) {
+      table_size *= 2u;
+    }
+    if (table_size == loans.size()) {
+      return;
+    }
+    std::vector<Item *> old_loans(table_size, nullptr);
+    old_loans.swap(loans);
+    loans_mask = table_size - 1u;
+    for (Item * item : old_loans) {
+      if (nullptr != item) {
+        size_t index = home_slot(item->message);
+        while (nullptr != loans[index]) {
+          index = (index + 1) & loans_mask;
+        }
+        loans[index] = item;
+      }
+    }
+  }
+
+  const size_t max_items;
+  const size_t increment;
+
   std::mutex mtx;
-  using ItemVector = eprosima::fastrtps::ResourceLimitedVector<std::unique_ptr<Item>>;
-  ItemVector items RCPPUTILS_TSA_GUARDED_BY(mtx);
+  std::vector<std::unique_ptr<Item>> items RCPPUTILS_TSA_GUARDED_BY(mtx);
+  std::vector<Item *> free_items RCPPUTILS_TSA_GUARDED_BY(mtx);
+  std::vector<Item *> loans RCPPUTILS_TSA_GUARDED_BY(mtx);
+  size_t loans_mask RCPPUTILS_TSA_GUARDED_BY(mtx) {0};
 };
 
 void
@@ -591,9 +813,15 @@ __rmw_take_loaned_message_internal(
 
   auto info = static_cast<CustomSubscriberInfo *>(subscription->data);
 
-  auto item = std::make_unique<rmw_fastrtps_shared_cpp::LoanManager::Item>();
+  auto item = info->loan_manager_->acquire_item();
+  if (nullptr == item) {
+    RMW_SET_ERROR_MSG("Too many outstanding loans on subscription");
+    return RMW_RET_ERROR;
+  }
 
-  while (ReturnCode_t::RETCODE_OK == info->data_reader_->take(item->data_seq, item->info_seq, 1)) {
+  while (ReturnCode_t::RETCODE_OK ==
+    info->ready_counter_.take(info->data_reader_, item->data_seq, item->info_seq, 1))
+  {
     if (item->info_seq[0].valid_data) {
       if (nullptr != message_info) {
         _assign_message_info(identifier, message_info, &item->info_seq[0]);
@@ -601,7 +829,7 @@ __rmw_take_loaned_message_internal(
       *loaned_message = item->data_seq.buffer()[0];
       *taken = true;
 
-      info->loan_manager_->add_item(std::move(item));
+      info->loan_manager_->add_item(item, *loaned_message);
 
       return RMW_RET_OK;
     }
@@ -610,6 +838,8 @@ __rmw_take_loaned_message_internal(
     info->data_reader_->return_loan(item->data_seq, item->info_seq);
   }
 
+  info->loan_manager_->release_item(item);
+
   // No data available, return loan information.
   *taken = false;
   return RMW_RET_OK;
@@ -632,14 +862,16 @@ __rmw_return_loaned_message_from_subscription(
   RMW_CHECK_ARGUMENT_FOR_NULL(loaned_message, RMW_RET_INVALID_ARGUMENT);
 
   auto info = static_cast<CustomSubscriberInfo *>(subscription->data);
-  std::unique_ptr<rmw_fastrtps_shared_cpp::LoanManager::Item> item;
-  item = info->loan_manager_->erase_item(loaned_message);
+  auto item = info->loan_manager_->erase_item(loaned_message);
   if (item != nullptr) {
     if (!info->data_reader_->return_loan(item->data_seq, item->info_seq)) {
+      // Keep track of the loan, so returning it can be retried
+      info->loan_manager_->add_item(item, loaned_message);
       RMW_SET_ERROR_MSG("Error returning loan");
       return RMW_RET_ERROR;
     }
 
+    info->loan_manager_->release_item(item);
     return RMW_RET_OK;
   }
 
@@ -647,4 +879,126 @@ __rmw_return_loaned_message_from_subscription(
   return RMW_RET_ERROR;
 }
 
+rmw_ret_t
+__rmw_take_loaned_message_sequence(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  size_t count,
+  rmw_message_sequence_t * message_sequence,
+  rmw_message_info_sequence_t * message_info_sequence,
+  size_t * taken)
+{
+  RMW_CHECK_ARGUMENT_FOR_NULL(subscription, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    subscription, subscription->implementation_identifier, identifier,
+    return RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
+  if (!subscription->can_loan_messages) {
+    RMW_SET_ERROR_MSG("Loaning is not supported");
+    return RMW_RET_UNSUPPORTED;
+  }
+
+  RMW_CHECK_ARGUMENT_FOR_NULL(message_sequence, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(taken, RMW_RET_INVALID_ARGUMENT);
+
+  if (0u == count) {
+    RMW_SET_ERROR_MSG("count cannot be 0");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (count > message_sequence->capacity) {
+    RMW_SET_ERROR_MSG("Insufficient capacity in message_sequence");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (nullptr != message_info_sequence && count > message_info_sequence->capacity) {
+    RMW_SET_ERROR_MSG("Insufficient capacity in message_info_sequence");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (count > static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+    count = static_cast<size_t>(std::numeric_limits<int32_t>::max());
+  }
+
+  *taken = 0u;
+  message_sequence->size = 0u;
+  if (nullptr != message_info_sequence) {
+    message_info_sequence->size = 0u;
+  }
+
+  auto info = static_cast<CustomSubscriberInfo *>(subscription->data);
+
+  auto item = info->loan_manager_->acquire_item();
+  if (nullptr == item) {
+    RMW_SET_ERROR_MSG("Too many outstanding loans on subscription");
+    return RMW_RET_ERROR;
+  }
+
+  // All the samples are loaned with a single take, and held by the same item until the whole
+  // sequence is returned
+  const auto max_samples = static_cast<int32_t>(count);
+  while (ReturnCode_t::RETCODE_OK ==
+    info->ready_counter_.take(info->data_reader_, item->data_seq, item->info_seq, max_samples))
+  {
+    const auto received = static_cast<size_t>(item->info_seq.length());
+    for (size_t ii = 0; ii < received; ++ii) {
+      if (!item->info_seq[ii].valid_data) {
+        continue;
+      }
+      if (nullptr != message_info_sequence) {
+        _assign_message_info(
+          identifier, &message_info_sequence->data[*taken], &item->info_seq[ii]);
+      }
+      message_sequence->data[*taken] = item->data_seq.buffer()[ii];
+      (*taken)++;
+    }
+
+    if (*taken > 0u) {
+      message_sequence->size = *taken;
+      if (nullptr != message_info_sequence) {
+        message_info_sequence->size = *taken;
+      }
+
+      info->loan_manager_->add_item(item, message_sequence->data[0]);
+
+      return RMW_RET_OK;
+    }
+
+    // Should return loan before taking again
+    info->data_reader_->return_loan(item->data_seq, item->info_seq);
+  }
+
+  info->loan_manager_->release_item(item);
+
+  // No data available, return loan information.
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_return_loaned_message_sequence(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  rmw_message_sequence_t * message_sequence)
+{
+  RMW_CHECK_ARGUMENT_FOR_NULL(subscription, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    subscription, subscription->implementation_identifier, identifier,
+    return RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
+  if (!subscription->can_loan_messages) {
+    RMW_SET_ERROR_MSG("Loaning is not supported");
+    return RMW_RET_UNSUPPORTED;
+  }
+  RMW_CHECK_ARGUMENT_FOR_NULL(message_sequence, RMW_RET_INVALID_ARGUMENT);
+  if (0u == message_sequence->size) {
+    RMW_SET_ERROR_MSG("message_sequence does not hold loaned messages");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  rmw_ret_t ret = __rmw_return_loaned_message_from_subscription(
+    identifier, subscription, message_sequence->data[0]);
+  if (RMW_RET_OK == ret) {
+    message_sequence->size = 0u;
+  }
+  return ret;
+}
+
 }  // namespace rmw_fastrtps_shared_cpp
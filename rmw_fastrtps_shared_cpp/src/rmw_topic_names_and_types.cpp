@@ -54,8 +54,8 @@ __rmw_get_topic_names_and_types(
     return RMW_RET_INVALID_ARGUMENT;
   }
 
-  DemangleFunction demangle_topic = _demangle_ros_topic_from_topic;
-  DemangleFunction demangle_type = _demangle_if_ros_type;
+  DemangleFunction demangle_topic = _demangle_ros_topic_from_topic_cached;
+  DemangleFunction demangle_type = _demangle_if_ros_type_cached;
 
   if (no_demangle) {
     demangle_topic = _identity_demangle;
@@ -63,9 +63,16 @@ __rmw_get_topic_names_and_types(
   }
   auto common_context = static_cast<rmw_dds_common::Context *>(node->context->impl->common);
 
-  return common_context->graph_cache.get_names_and_types(
-    demangle_topic,
-    demangle_type,
+  return node->context->impl->names_and_types_cache.get(
+    no_demangle ? "topics" : "topics/demangled",
+    [&](rcutils_allocator_t * query_allocator, rmw_names_and_types_t * result) -> rmw_ret_t
+    {
+      return common_context->graph_cache.get_names_and_types(
+        demangle_topic,
+        demangle_type,
+        query_allocator,
+        result);
+    },
     allocator,
     topic_names_and_types);
 }
@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+
 #include "rcutils/macros.h"
 
 #include "rmw/error_handling.h"
@@ -21,9 +23,9 @@
 #include "rmw_fastrtps_shared_cpp/custom_service_info.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_subscriber_info.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+#include "types/custom_wait_set_info.hpp"
 #include "types/event_types.hpp"
 
-#include "fastdds/dds/core/condition/WaitSet.hpp"
 #include "fastdds/dds/core/condition/GuardCondition.hpp"
 #include "fastdds/dds/subscriber/DataReader.hpp"
 
@@ -48,11 +50,7 @@ static bool has_triggered_condition(
   rmw_clients_t * clients,
   rmw_events_t * events)
 {
-  // `get_first_untaken_info` is relatively more expensive than checking guard conditions,
-  // so should be skipped if possible.
-  // Subscriptions, services, and clients typically have additional waitables
-  // connected (eg receive event or intraprocess waitable), so we can hit those first
-  // before having to query SampleInfo.
+  // Subscriptions, services, and clients are checked with their ReadyCounter
   if (guard_conditions) {
     for (size_t i = 0; i < guard_conditions->guard_condition_count; ++i) {
       void * data = guard_conditions->guard_conditions[i];
@@ -79,10 +77,7 @@ static bool has_triggered_condition(
     for (size_t i = 0; i < subscriptions->subscriber_count; ++i) {
       void * data = subscriptions->subscribers[i];
       auto custom_subscriber_info = static_cast<CustomSubscriberInfo *>(data);
-      eprosima::fastdds::dds::SampleInfo sample_info;
-      if (ReturnCode_t::RETCODE_OK ==
-        custom_subscriber_info->data_reader_->get_first_untaken_info(&sample_info))
-      {
+      if (custom_subscriber_info->ready_counter_.is_ready()) {
         return true;
       }
     }
@@ -92,10 +87,7 @@ static bool has_triggered_condition(
     for (size_t i = 0; i < clients->client_count; ++i) {
       void * data = clients->clients[i];
       auto custom_client_info = static_cast<CustomClientInfo *>(data);
-      eprosima::fastdds::dds::SampleInfo sample_info;
-      if (ReturnCode_t::RETCODE_OK ==
-        custom_client_info->response_reader_->get_first_untaken_info(&sample_info))
-      {
+      if (custom_client_info->ready_counter_.is_ready()) {
         return true;
       }
     }
@@ -105,10 +97,7 @@ static bool has_triggered_condition(
     for (size_t i = 0; i < services->service_count; ++i) {
       void * data = services->services[i];
       auto custom_service_info = static_cast<CustomServiceInfo *>(data);
-      eprosima::fastdds::dds::SampleInfo sample_info;
-      if (ReturnCode_t::RETCODE_OK ==
-        custom_service_info->request_reader_->get_first_untaken_info(&sample_info))
-      {
+      if (custom_service_info->ready_counter_.is_ready()) {
         return true;
       }
     }
@@ -142,23 +131,25 @@ __rmw_wait(
   // error.
   // - Heap is corrupt.
   // In all three cases, it's better if this crashes soon enough.
-  auto fastdds_wait_set = static_cast<eprosima::fastdds::dds::WaitSet *>(wait_set->data);
+  auto wait_set_info = static_cast<CustomWaitsetInfo *>(wait_set->data);
 
   /// Check if any conditions are already true before waiting,
   /// allowing us to skip some work of attaching/detaching
   bool skip_wait = has_triggered_condition(
     subscriptions, guard_conditions, services, clients, events);
   bool wait_result = true;
-  std::vector<eprosima::fastdds::dds::Condition *> attached_conditions;
 
   if (!skip_wait) {
     // In the case that a wait is needed (no triggered conditions), gather the conditions
-    // to be added to the waitset.
+    // that should be attached to the waitset.
+    auto & wanted_conditions = wait_set_info->wanted_conditions_;
+    wanted_conditions.clear();
+
     if (subscriptions) {
       for (size_t i = 0; i < subscriptions->subscriber_count; ++i) {
         void * data = subscriptions->subscribers[i];
         auto custom_subscriber_info = static_cast<CustomSubscriberInfo *>(data);
-        attached_conditions.push_back(
+        wanted_conditions.push_back(
           &custom_subscriber_info->data_reader_->get_statuscondition());
       }
     }
@@ -167,7 +158,7 @@ __rmw_wait(
       for (size_t i = 0; i < clients->client_count; ++i) {
         void * data = clients->clients[i];
         auto custom_client_info = static_cast<CustomClientInfo *>(data);
-        attached_conditions.push_back(
+        wanted_conditions.push_back(
           &custom_client_info->response_reader_->get_statuscondition());
       }
     }
@@ -176,7 +167,7 @@ __rmw_wait(
       for (size_t i = 0; i < services->service_count; ++i) {
         void * data = services->services[i];
         auto custom_service_info = static_cast<CustomServiceInfo *>(data);
-        attached_conditions.push_back(
+        wanted_conditions.push_back(
           &custom_service_info->request_reader_->get_statuscondition());
       }
     }
@@ -185,9 +176,9 @@ __rmw_wait(
       for (size_t i = 0; i < events->event_count; ++i) {
         auto event = static_cast<rmw_event_t *>(events->events[i]);
         auto custom_event_info = static_cast<CustomEventInfo *>(event->data);
-        attached_conditions.push_back(
+        wanted_conditions.push_back(
           &custom_event_info->get_listener()->get_statuscondition());
-        attached_conditions.push_back(
+        wanted_conditions.push_back(
           &custom_event_info->get_listener()->get_event_guard(event->event_type));
       }
     }
@@ -195,34 +186,51 @@ __rmw_wait(
     if (guard_conditions) {
       for (size_t i = 0; i < guard_conditions->guard_condition_count; ++i) {
         void * data = guard_conditions->guard_conditions[i];
-        attached_conditions.push_back(
+        wanted_conditions.push_back(
           static_cast<eprosima::fastdds::dds::GuardCondition *>(data));
       }
     }
 
-    // Attach all of the conditions to the wait set.
-    // TODO(mjcarroll): When upstream has the ability to attach a vector of conditions,
-    // switch to that API
-    for (auto & condition : attached_conditions) {
-      fastdds_wait_set->attach_condition(*condition);
+    // Events share the status condition of their entity, so remove duplicates.
+    std::sort(wanted_conditions.begin(), wanted_conditions.end());
+    wanted_conditions.erase(
+      std::unique(wanted_conditions.begin(), wanted_conditions.end()),
+      wanted_conditions.end());
+
+    // Conditions are kept attached between calls. Ask the wait set which ones are still attached,
+    // as conditions are automatically detached by Fast DDS when they are destroyed, and only
+    // attach or detach the difference.
+    auto & attached_conditions = wait_set_info->attached_conditions_;
+    wait_set_info->wait_set_.get_conditions(attached_conditions);
+    std::sort(attached_conditions.begin(), attached_conditions.end());
+
+    auto wanted_it = wanted_conditions.begin();
+    auto attached_it = attached_conditions.begin();
+    while (wanted_it != wanted_conditions.end() || attached_it != attached_conditions.end()) {
+      if (attached_it == attached_conditions.end() ||
+        (wanted_it != wanted_conditions.end() && *wanted_it < *attached_it))
+      {
+        wait_set_info->wait_set_.attach_condition(**wanted_it);
+        ++wanted_it;
+      } else if (wanted_it == wanted_conditions.end() || *attached_it < *wanted_it) {
+        wait_set_info->wait_set_.detach_condition(**attached_it);
+        ++attached_it;
+      } else {
+        ++wanted_it;
+        ++attached_it;
+      }
     }
 
     Duration_t timeout = (wait_timeout) ?
       Duration_t{static_cast<int32_t>(wait_timeout->sec),
       static_cast<uint32_t>(wait_timeout->nsec)} : eprosima::fastrtps::c_TimeInfinite;
 
-    eprosima::fastdds::dds::ConditionSeq triggered_conditions;
-    ReturnCode_t ret_code = fastdds_wait_set->wait(
+    auto & triggered_conditions = wait_set_info->triggered_conditions_;
+    triggered_conditions.clear();
+    ReturnCode_t ret_code = wait_set_info->wait_set_.wait(
       triggered_conditions,
       timeout);
     wait_result = (ret_code == ReturnCode_t::RETCODE_OK);
-
-    // Detach all of the conditions from the wait set.
-    // TODO(mjcarroll): When upstream has the ability to detach a vector of conditions,
-    // switch to that API
-    for (auto & condition : attached_conditions) {
-      fastdds_wait_set->detach_condition(*condition);
-    }
   }
 
   // Check the results of the wait, and mark ready entities accordingly.
@@ -231,10 +239,7 @@ __rmw_wait(
       void * data = subscriptions->subscribers[i];
       auto custom_subscriber_info = static_cast<CustomSubscriberInfo *>(data);
 
-      eprosima::fastdds::dds::SampleInfo sample_info;
-      if (ReturnCode_t::RETCODE_OK !=
-        custom_subscriber_info->data_reader_->get_first_untaken_info(&sample_info))
-      {
+      if (!custom_subscriber_info->ready_counter_.is_ready()) {
         subscriptions->subscribers[i] = 0;
       }
     }
@@ -245,10 +250,7 @@ __rmw_wait(
       void * data = clients->clients[i];
       auto custom_client_info = static_cast<CustomClientInfo *>(data);
 
-      eprosima::fastdds::dds::SampleInfo sample_info;
-      if (ReturnCode_t::RETCODE_OK !=
-        custom_client_info->response_reader_->get_first_untaken_info(&sample_info))
-      {
+      if (!custom_client_info->ready_counter_.is_ready()) {
         clients->clients[i] = 0;
       }
     }
@@ -258,11 +260,7 @@ __rmw_wait(
     for (size_t i = 0; i < services->service_count; ++i) {
       void * data = services->services[i];
       auto custom_service_info = static_cast<CustomServiceInfo *>(data);
-
-      eprosima::fastdds::dds::SampleInfo sample_info;
-      if (ReturnCode_t::RETCODE_OK !=
-        custom_service_info->request_reader_->get_first_untaken_info(&sample_info))
-      {
+      if (!custom_service_info->ready_counter_.is_ready()) {
         services->services[i] = 0;
       }
     }
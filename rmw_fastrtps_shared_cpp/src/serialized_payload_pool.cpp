@@ -0,0 +1,199 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#include "rmw_fastrtps_shared_cpp/serialized_payload_pool.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+using eprosima::fastrtps::rtps::CacheChange_t;
+using eprosima::fastrtps::rtps::IPayloadPool;
+using eprosima::fastrtps::rtps::SerializedPayload_t;
+
+namespace
+{
+
+// Buffer lent to the writer by the PublishScope of this thread
+struct PendingBuffer
+{
+  SerializedPayloadPool * pool = nullptr;
+  SerializedPayloadPool::octet * buffer = nullptr;
+  bool taken = false;
+};
+
+thread_local PendingBuffer pending_buffer;
+
+}  // namespace
+
+SerializedPayloadPool::PublishScope::PublishScope(SerializedPayloadPool & pool, octet * buffer)
+: pool_(pool), buffer_(buffer)
+{
+  pending_buffer.pool = &pool_;
+  pending_buffer.buffer = buffer_;
+  pending_buffer.taken = false;
+}
+
+SerializedPayloadPool::PublishScope::~PublishScope()
+{
+  pending_buffer = PendingBuffer();
+}
+
+bool
+SerializedPayloadPool::PublishScope::buffer_taken() const
+{
+  return &pool_ == pending_buffer.pool && buffer_ == pending_buffer.buffer &&
+         pending_buffer.taken;
+}
+
+SerializedPayloadPool::SerializedPayloadPool(size_t max_free_buffers)
+: max_free_buffers_(max_free_buffers)
+{
+}
+
+SerializedPayloadPool::octet *
+SerializedPayloadPool::acquire(uint32_t size, uint32_t & capacity)
+{
+  // Smallest free buffer which is big enough
+  auto it = free_buffers_.lower_bound(size);
+  if (it != free_buffers_.end()) {
+    octet * buffer = it->second;
+    capacity = it->first;
+    free_buffers_.erase(it);
+    return buffer;
+  }
+
+  std::unique_ptr<octet[]> data(new (std::nothrow) octet[size > 0u ? size : 1u]);
+  if (!data) {
+    return nullptr;
+  }
+  octet * buffer = data.get();
+  buffers_.emplace(buffer, std::make_pair(std::move(data), size));
+  capacity = size;
+  return buffer;
+}
+
+void
+SerializedPayloadPool::release(octet * buffer)
+{
+  auto it = buffers_.find(buffer);
+  if (it == buffers_.end()) {
+    return;
+  }
+  if (free_buffers_.size() < max_free_buffers_) {
+    free_buffers_.emplace(it->second.second, buffer);
+  } else {
+    buffers_.erase(it);
+  }
+}
+
+SerializedPayloadPool::octet *
+SerializedPayloadPool::borrow(uint32_t size, uint32_t & capacity)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  octet * buffer = acquire(size, capacity);
+  if (buffer) {
+    borrowed_buffers_.insert(buffer);
+  }
+  return buffer;
+}
+
+bool
+SerializedPayloadPool::give_back(octet * buffer)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (0u == borrowed_buffers_.erase(buffer)) {
+    return false;
+  }
+  release(buffer);
+  return true;
+}
+
+bool
+SerializedPayloadPool::is_borrowed(const octet * buffer)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return borrowed_buffers_.count(const_cast<octet *>(buffer)) > 0u;
+}
+
+bool
+SerializedPayloadPool::get_payload(uint32_t size, CacheChange_t & cache_change)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  octet * buffer = nullptr;
+  uint32_t capacity = 0u;
+  if (this == pending_buffer.pool && !pending_buffer.taken) {
+    // The sample being written is the borrowed buffer itself
+    buffer = pending_buffer.buffer;
+    capacity = buffers_[buffer].second;
+    if (capacity < size || 0u == borrowed_buffers_.erase(buffer)) {
+      return false;
+    }
+    pending_buffer.taken = true;
+  } else {
+    buffer = acquire(size, capacity);
+    if (!buffer) {
+      return false;
+    }
+  }
+
+  cache_change.serializedPayload.data = buffer;
+  cache_change.serializedPayload.max_size = capacity;
+  cache_change.serializedPayload.length = 0u;
+  cache_change.payload_owner(this);
+  return true;
+}
+
+bool
+SerializedPayloadPool::get_payload(
+  SerializedPayload_t & data,
+  IPayloadPool * & data_owner,
+  CacheChange_t & cache_change)
+{
+  // Buffers are never shared, so the data is always copied and data_owner is left untouched
+  static_cast<void>(data_owner);
+  if (!get_payload(data.length, cache_change)) {
+    return false;
+  }
+  if (!cache_change.serializedPayload.copy(&data, true)) {
+    release_payload(cache_change);
+    return false;
+  }
+  return true;
+}
+
+bool
+SerializedPayloadPool::release_payload(CacheChange_t & cache_change)
+{
+  if (this != cache_change.payload_owner()) {
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    release(cache_change.serializedPayload.data);
+  }
+
+  cache_change.serializedPayload.data = nullptr;
+  cache_change.serializedPayload.max_size = 0u;
+  cache_change.serializedPayload.length = 0u;
+  cache_change.payload_owner(nullptr);
+  return true;
+}
+
+}  // namespace rmw_fastrtps_shared_cpp
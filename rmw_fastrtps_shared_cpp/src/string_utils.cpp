@@ -0,0 +1,54 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "string_utils.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+std::vector<std::string>
+split(const std::string & value, char delimiter)
+{
+  std::vector<std::string> items;
+  size_t start = 0;
+  while (start <= value.size()) {
+    size_t end = value.find(delimiter, start);
+    if (std::string::npos == end) {
+      end = value.size();
+    }
+    items.push_back(value.substr(start, end - start));
+    start = end + 1;
+  }
+  return items;
+}
+
+bool
+parse_integer(const std::string & value, int64_t min, int64_t max, int64_t & result)
+{
+  if (value.empty()) {
+    return false;
+  }
+  char * end = nullptr;
+  errno = 0;
+  result = static_cast<int64_t>(std::strtoll(value.c_str(), &end, 10));
+  return 0 == errno && '\0' == *end && result >= min && result <= max;
+}
+
+}  // namespace rmw_fastrtps_shared_cpp
@@ -0,0 +1,34 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef STRING_UTILS_HPP_
+#define STRING_UTILS_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+// Split value at each delimiter, keeping empty items
+std::vector<std::string> split(const std::string & value, char delimiter);
+
+// Parse value as a base 10 integer in [min, max] into result.
+// Returns false if value is empty, has trailing characters, or is out of range.
+bool parse_integer(const std::string & value, int64_t min, int64_t max, int64_t & result);
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // STRING_UTILS_HPP_
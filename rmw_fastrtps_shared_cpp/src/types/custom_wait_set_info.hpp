@@ -0,0 +1,37 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TYPES__CUSTOM_WAIT_SET_INFO_HPP_
+#define TYPES__CUSTOM_WAIT_SET_INFO_HPP_
+
+#include "fastdds/dds/core/condition/Condition.hpp"
+#include "fastdds/dds/core/condition/WaitSet.hpp"
+
+/// Data stored in rmw_wait_set_t::data.
+/**
+ * Conditions stay attached to wait_set_ between calls to rmw_wait, so only the entities that
+ * were added or removed since the previous call need to be attached or detached.
+ * Conditions that are destroyed while attached are automatically detached by Fast DDS.
+ */
+struct CustomWaitsetInfo
+{
+  eprosima::fastdds::dds::WaitSet wait_set_;
+
+  // Scratch storage reused on every call to rmw_wait, to avoid allocations once warmed up.
+  eprosima::fastdds::dds::ConditionSeq attached_conditions_;
+  eprosima::fastdds::dds::ConditionSeq wanted_conditions_;
+  eprosima::fastdds::dds::ConditionSeq triggered_conditions_;
+};
+
+#endif  // TYPES__CUSTOM_WAIT_SET_INFO_HPP_
@@ -0,0 +1,46 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TYPES__SERIALIZED_DATA_SEQUENCE_HPP_
+#define TYPES__SERIALIZED_DATA_SEQUENCE_HPP_
+
+#include <new>
+
+#include "fastdds/dds/core/LoanableCollection.hpp"
+
+/// Collection of pointers to SerializedData used for batched takes.
+/**
+ * The pointers are owned by the caller, so this collection can not grow.
+ */
+struct SerializedDataSequence : public eprosima::fastdds::dds::LoanableCollection
+{
+  SerializedDataSequence(
+    void ** pointers,
+    size_type maximum)
+  {
+    has_ownership_ = true;
+    maximum_ = maximum;
+    length_ = 0;
+    elements_ = pointers;
+  }
+
+  void resize(
+    size_type /*new_length*/) override
+  {
+    // Capacity is fixed on construction
+    throw std::bad_alloc();
+  }
+};
+
+#endif  // TYPES__SERIALIZED_DATA_SEQUENCE_HPP_
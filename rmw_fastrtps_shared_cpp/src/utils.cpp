@@ -12,6 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
 #include <string>
 
 #include "rmw_fastrtps_shared_cpp/utils.hpp"
@@ -24,9 +28,45 @@
 
 #include "rmw/rmw.h"
 
+#include "rmw_fastrtps_shared_cpp/response_filter.hpp"
+
 using ReturnCode_t = eprosima::fastrtps::types::ReturnCode_t;
 
 const char * const CONTENT_FILTERED_TOPIC_POSTFIX = "_filtered_name";
+const char * const RESPONSE_FILTERED_TOPIC_INFIX = "_response_filter_";
+
+namespace
+{
+
+// Match a name against a pattern where '*' matches any sequence of characters
+bool
+matches_pattern(const std::string & pattern, const std::string & name)
+{
+  size_t p = 0;
+  size_t n = 0;
+  size_t star = std::string::npos;
+  size_t star_n = 0;
+  while (n < name.size()) {
+    if (p < pattern.size() && pattern[p] == '*') {
+      star = p++;
+      star_n = n;
+    } else if (p < pattern.size() && pattern[p] == name[n]) {
+      ++p;
+      ++n;
+    } else if (std::string::npos != star) {
+      p = star + 1;
+      n = ++star_n;
+    } else {
+      return false;
+    }
+  }
+  while (p < pattern.size() && pattern[p] == '*') {
+    ++p;
+  }
+  return p == pattern.size();
+}
+
+}  // namespace
 
 namespace rmw_fastrtps_shared_cpp
 {
@@ -95,6 +135,74 @@ remove_topic_and_type(
   }
 }
 
+bool
+use_data_sharing(
+  const CustomParticipantInfo * participant_info,
+  const std::string & topic_name,
+  const eprosima::fastdds::dds::TypeSupport & type)
+{
+  if (participant_info->data_sharing_topics.empty() || !type->is_bounded()) {
+    return false;
+  }
+  for (const std::string & pattern : participant_info->data_sharing_topics) {
+    if (matches_pattern(pattern, topic_name)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::shared_ptr<SerializedPayloadPool>
+create_payload_pool(
+  const CustomParticipantInfo * participant_info,
+  const std::string & topic_name,
+  const eprosima::fastdds::dds::DataWriterQos & writer_qos)
+{
+  if (eprosima::fastdds::dds::OFF != writer_qos.data_sharing().kind()) {
+    return nullptr;
+  }
+  bool borrowed_payloads = false;
+  for (const std::string & pattern : participant_info->borrowed_payload_topics) {
+    if (matches_pattern(pattern, topic_name)) {
+      borrowed_payloads = true;
+      break;
+    }
+  }
+  if (!borrowed_payloads) {
+    return nullptr;
+  }
+
+  int32_t max_samples = writer_qos.resource_limits().max_samples;
+  if (eprosima::fastdds::dds::KEEP_LAST_HISTORY_QOS == writer_qos.history().kind) {
+    max_samples = writer_qos.history().depth;
+  }
+  // Unlimited histories keep every buffer they needed at once
+  size_t max_free_buffers = max_samples > 0 ?
+    static_cast<size_t>(max_samples) : std::numeric_limits<size_t>::max();
+  return std::make_shared<SerializedPayloadPool>(max_free_buffers);
+}
+
+bool
+use_flow_controller(
+  const CustomParticipantInfo * participant_info,
+  const std::string & topic_name,
+  eprosima::fastdds::dds::DataWriterQos & writer_qos)
+{
+  if (!participant_info->flow_control) {
+    return false;
+  }
+  for (const FlowControlledTopic & topic : participant_info->flow_control->topics) {
+    if (matches_pattern(topic.topic_pattern, topic_name)) {
+      writer_qos.publish_mode().kind = eprosima::fastrtps::ASYNCHRONOUS_PUBLISH_MODE;
+      writer_qos.publish_mode().flow_controller_name = topic.flow_controller_name;
+      writer_qos.properties().properties().emplace_back(
+        "fastdds.sfc.priority", std::to_string(topic.priority));
+      return true;
+    }
+  }
+  return false;
+}
+
 bool
 create_content_filtered_topic(
   eprosima::fastdds::dds::DomainParticipant * participant,
@@ -124,6 +232,32 @@ create_content_filtered_topic(
   return true;
 }
 
+bool
+create_response_filtered_topic(
+  eprosima::fastdds::dds::DomainParticipant * participant,
+  eprosima::fastdds::dds::Topic * response_topic,
+  eprosima::fastdds::dds::ContentFilteredTopic ** content_filtered_topic)
+{
+  // Every client of a participant needs its own name, as topic names are unique
+  static std::atomic<uint64_t> filtered_topic_count{0};
+  std::string cft_topic_name = response_topic->get_name() + RESPONSE_FILTERED_TOPIC_INFIX +
+    std::to_string(filtered_topic_count++);
+
+  eprosima::fastdds::dds::ContentFilteredTopic * filtered_topic =
+    participant->create_contentfilteredtopic(
+    cft_topic_name,
+    response_topic,
+    ResponseFilter::expression,
+    {},
+    ResponseFilter::class_name);
+  if (filtered_topic == nullptr) {
+    return false;
+  }
+
+  *content_filtered_topic = filtered_topic;
+  return true;
+}
+
 bool
 create_datareader(
   const eprosima::fastdds::dds::DataReaderQos & datareader_qos,
@@ -161,7 +295,8 @@ create_datareader(
     des_topic,
     updated_qos,
     listener,
-    eprosima::fastdds::dds::StatusMask::subscription_matched());
+    eprosima::fastdds::dds::StatusMask::subscription_matched() <<
+    eprosima::fastdds::dds::StatusMask::data_available());
   if (!data_reader &&
     (RMW_UNIQUE_NETWORK_FLOW_ENDPOINTS_OPTIONALLY_REQUIRED ==
     subscription_options->require_unique_network_flow_endpoints))
@@ -170,7 +305,8 @@ create_datareader(
       des_topic,
       datareader_qos,
       listener,
-      eprosima::fastdds::dds::StatusMask::subscription_matched());
+      eprosima::fastdds::dds::StatusMask::subscription_matched() <<
+      eprosima::fastdds::dds::StatusMask::data_available());
   }
   return true;
 }
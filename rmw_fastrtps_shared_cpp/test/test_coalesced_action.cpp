@@ -0,0 +1,157 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <cstddef>
+
+#include "gtest/gtest.h"
+
+#include "rmw_fastrtps_shared_cpp/coalesced_action.hpp"
+
+using rmw_fastrtps_shared_cpp::CoalescedAction;
+
+namespace
+{
+
+constexpr std::chrono::milliseconds period{50};
+
+class CoalescedActionTest : public ::testing::Test
+{
+protected:
+  CoalescedAction
+  make_action()
+  {
+    return CoalescedAction(
+      period,
+      [this]() {
+        ++runs;
+        return action_result;
+      },
+      [this]() {
+        ++wakes;
+        return RMW_RET_OK;
+      },
+      [this]() {return now;});
+  }
+
+  CoalescedAction::Clock::time_point now{std::chrono::seconds(1)};
+  size_t runs = 0u;
+  size_t wakes = 0u;
+  rmw_ret_t action_result = RMW_RET_OK;
+};
+
+}  // namespace
+
+TEST_F(CoalescedActionTest, coalesces_requests_within_period) {
+  CoalescedAction action = make_action();
+  CoalescedAction::Clock::time_point deadline;
+  EXPECT_FALSE(action.get_pending_deadline(deadline));
+
+  // Nothing ran during the last period
+  EXPECT_EQ(RMW_RET_OK, action.request());
+  EXPECT_EQ(1u, runs);
+  EXPECT_EQ(0u, wakes);
+  EXPECT_FALSE(action.get_pending_deadline(deadline));
+
+  now += std::chrono::milliseconds(10);
+  EXPECT_EQ(RMW_RET_OK, action.request());
+  EXPECT_EQ(RMW_RET_OK, action.request());
+  EXPECT_EQ(1u, runs);
+  EXPECT_EQ(1u, wakes);
+  ASSERT_TRUE(action.get_pending_deadline(deadline));
+  EXPECT_EQ(now - std::chrono::milliseconds(10) + period, deadline);
+
+  now += std::chrono::milliseconds(30);
+  EXPECT_EQ(RMW_RET_OK, action.run_pending());
+  EXPECT_EQ(1u, runs);
+
+  now = deadline;
+  EXPECT_EQ(RMW_RET_OK, action.run_pending());
+  EXPECT_EQ(2u, runs);
+  EXPECT_FALSE(action.get_pending_deadline(deadline));
+  EXPECT_EQ(RMW_RET_OK, action.run_pending());
+  EXPECT_EQ(2u, runs);
+
+  // The period starts over from the pending run
+  now += std::chrono::milliseconds(20);
+  EXPECT_EQ(RMW_RET_OK, action.request());
+  EXPECT_EQ(2u, runs);
+  EXPECT_EQ(2u, wakes);
+  now += period;
+  EXPECT_EQ(RMW_RET_OK, action.request());
+  EXPECT_EQ(2u, runs);
+  EXPECT_EQ(RMW_RET_OK, action.run_pending());
+  EXPECT_EQ(3u, runs);
+}
+
+TEST_F(CoalescedActionTest, zero_period_runs_every_request) {
+  CoalescedAction action(
+    std::chrono::milliseconds(0),
+    [this]() {
+      ++runs;
+      return RMW_RET_OK;
+    },
+    [this]() {
+      ++wakes;
+      return RMW_RET_OK;
+    },
+    [this]() {return now;});
+  for (size_t ii = 0u; ii < 3u; ++ii) {
+    EXPECT_EQ(RMW_RET_OK, action.request());
+  }
+  EXPECT_EQ(3u, runs);
+  EXPECT_EQ(0u, wakes);
+}
+
+TEST_F(CoalescedActionTest, flush_on_shutdown) {
+  CoalescedAction action = make_action();
+  // Nothing pending
+  EXPECT_EQ(RMW_RET_OK, action.flush());
+  EXPECT_EQ(0u, runs);
+
+  EXPECT_EQ(RMW_RET_OK, action.request());
+  EXPECT_EQ(RMW_RET_OK, action.request());
+  EXPECT_EQ(1u, runs);
+
+  // Runs the pending request before the end of the period
+  EXPECT_EQ(RMW_RET_OK, action.flush());
+  EXPECT_EQ(2u, runs);
+  CoalescedAction::Clock::time_point deadline;
+  EXPECT_FALSE(action.get_pending_deadline(deadline));
+  EXPECT_EQ(RMW_RET_OK, action.flush());
+  EXPECT_EQ(2u, runs);
+}
+
+TEST_F(CoalescedActionTest, immediate_request) {
+  CoalescedAction action = make_action();
+  EXPECT_EQ(RMW_RET_OK, action.request());
+  EXPECT_EQ(RMW_RET_OK, action.request());
+  EXPECT_EQ(1u, runs);
+
+  // Runs right away, along with the pending request
+  EXPECT_EQ(RMW_RET_OK, action.request(true));
+  EXPECT_EQ(2u, runs);
+  CoalescedAction::Clock::time_point deadline;
+  EXPECT_FALSE(action.get_pending_deadline(deadline));
+  EXPECT_EQ(RMW_RET_OK, action.run_pending());
+  EXPECT_EQ(2u, runs);
+}
+
+TEST_F(CoalescedActionTest, action_result) {
+  CoalescedAction action = make_action();
+  action_result = RMW_RET_ERROR;
+  EXPECT_EQ(RMW_RET_ERROR, action.request());
+  EXPECT_EQ(RMW_RET_OK, action.request());
+  EXPECT_EQ(RMW_RET_ERROR, action.flush());
+}
@@ -0,0 +1,135 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "rmw_fastrtps_shared_cpp/event_callback_slot.hpp"
+
+using rmw_fastrtps_shared_cpp::EventCallbackSlot;
+
+namespace
+{
+
+struct Counter
+{
+  std::atomic<size_t> calls{0u};
+  std::atomic<size_t> total{0u};
+};
+
+void count_callback(const void * user_data, size_t count)
+{
+  auto counter = static_cast<Counter *>(const_cast<void *>(user_data));
+  counter->calls++;
+  counter->total += count;
+}
+
+struct Reentrant
+{
+  EventCallbackSlot * slot;
+  Counter * next;
+};
+
+// Replaces itself from inside the callback
+void replacing_callback(const void * user_data, size_t)
+{
+  auto reentrant = static_cast<const Reentrant *>(user_data);
+  reentrant->slot->set(count_callback, reentrant->next);
+}
+
+struct Blocking
+{
+  std::atomic<bool> entered{false};
+  std::atomic<bool> release{false};
+};
+
+void blocking_callback(const void * user_data, size_t)
+{
+  auto blocking = static_cast<Blocking *>(const_cast<void *>(user_data));
+  blocking->entered = true;
+  while (!blocking->release) {
+    std::this_thread::yield();
+  }
+}
+
+}  // namespace
+
+TEST(EventCallbackSlotTest, call_and_replace) {
+  EventCallbackSlot slot;
+  EXPECT_FALSE(slot.call(1u));
+
+  Counter first;
+  slot.set(count_callback, &first);
+  EXPECT_TRUE(slot.call(2u));
+  EXPECT_TRUE(slot.call(3u));
+  EXPECT_EQ(2u, first.calls);
+  EXPECT_EQ(5u, first.total);
+
+  Counter second;
+  slot.set(count_callback, &second);
+  EXPECT_TRUE(slot.call(1u));
+  EXPECT_EQ(2u, first.calls);
+  EXPECT_EQ(1u, second.calls);
+
+  slot.set(nullptr, nullptr);
+  EXPECT_FALSE(slot.call(1u));
+  EXPECT_EQ(1u, second.calls);
+}
+
+TEST(EventCallbackSlotTest, set_from_callback) {
+  EventCallbackSlot slot;
+  Counter next;
+  Reentrant reentrant{&slot, &next};
+  slot.set(replacing_callback, &reentrant);
+
+  // Does not deadlock, and the new callback is called from then on
+  EXPECT_TRUE(slot.call(1u));
+  EXPECT_EQ(0u, next.calls);
+  EXPECT_TRUE(slot.call(4u));
+  EXPECT_EQ(1u, next.calls);
+  EXPECT_EQ(4u, next.total);
+}
+
+TEST(EventCallbackSlotTest, set_waits_for_running_call) {
+  EventCallbackSlot slot;
+  Blocking blocking;
+  slot.set(blocking_callback, &blocking);
+
+  std::thread caller([&slot]() {slot.call(1u);});
+  while (!blocking.entered) {
+    std::this_thread::yield();
+  }
+
+  std::atomic<bool> replaced{false};
+  Counter next;
+  std::thread setter([&]() {
+      slot.set(count_callback, &next);
+      replaced = true;
+    });
+
+  // set() does not return while the previous callback is running
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_FALSE(replaced);
+
+  blocking.release = true;
+  caller.join();
+  setter.join();
+  EXPECT_TRUE(replaced);
+  EXPECT_TRUE(slot.call(1u));
+  EXPECT_EQ(1u, next.calls);
+}
@@ -0,0 +1,170 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <set>
+
+#include "gtest/gtest.h"
+
+#include "rosidl_runtime_c/message_type_support_struct.h"
+#include "rosidl_typesupport_introspection_c/identifier.h"
+#include "rosidl_typesupport_introspection_c/message_introspection.h"
+
+#include "rmw_fastrtps_shared_cpp/loaned_message_pool.hpp"
+
+using rmw_fastrtps_shared_cpp::LoanedMessagePool;
+
+namespace
+{
+
+struct FakeMessage
+{
+  uint32_t value;
+  bool initialized;
+};
+
+size_t g_live_messages = 0;
+
+void fake_init(void * message, enum rosidl_runtime_c__message_initialization)
+{
+  auto fake = static_cast<FakeMessage *>(message);
+  fake->value = 0u;
+  fake->initialized = true;
+  ++g_live_messages;
+}
+
+void fake_fini(void * message)
+{
+  static_cast<FakeMessage *>(message)->initialized = false;
+  --g_live_messages;
+}
+
+class LoanedMessagePoolTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    members_ = rosidl_typesupport_introspection_c__MessageMembers();
+    members_.message_namespace_ = "test";
+    members_.message_name_ = "FakeMessage";
+    members_.size_of_ = sizeof(FakeMessage);
+    members_.init_function = fake_init;
+    members_.fini_function = fake_fini;
+
+    type_support_ = rosidl_message_type_support_t();
+    type_support_.typesupport_identifier = rosidl_typesupport_introspection_c__identifier;
+    type_support_.data = &members_;
+    type_support_.func = get_message_typesupport_handle_function;
+  }
+
+  rosidl_typesupport_introspection_c__MessageMembers members_;
+  rosidl_message_type_support_t type_support_;
+};
+
+}  // namespace
+
+TEST_F(LoanedMessagePoolTest, messages_are_initialized_once) {
+  {
+    auto pool = LoanedMessagePool::create(&type_support_, 4u);
+    ASSERT_NE(nullptr, pool);
+    EXPECT_EQ(4u, g_live_messages);
+
+    void * message = pool->borrow();
+    ASSERT_NE(nullptr, message);
+    EXPECT_TRUE(static_cast<FakeMessage *>(message)->initialized);
+    static_cast<FakeMessage *>(message)->value = 42u;
+    EXPECT_TRUE(pool->release(message));
+    EXPECT_EQ(4u, g_live_messages);
+  }
+  EXPECT_EQ(0u, g_live_messages);
+}
+
+TEST_F(LoanedMessagePoolTest, borrow_beyond_pool_size) {
+  {
+    auto pool = LoanedMessagePool::create(&type_support_, 3u);
+    ASSERT_NE(nullptr, pool);
+
+    std::set<void *> messages;
+    for (size_t i = 0; i < 5u; ++i) {
+      void * message = pool->borrow();
+      ASSERT_NE(nullptr, message);
+      EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(message) % alignof(std::max_align_t));
+      EXPECT_TRUE(static_cast<FakeMessage *>(message)->initialized);
+      messages.insert(message);
+    }
+    EXPECT_EQ(5u, messages.size());
+    EXPECT_EQ(5u, g_live_messages);
+
+    // Messages allocated beyond the pool size are destroyed when given back
+    for (void * message : messages) {
+      EXPECT_TRUE(pool->release(message));
+    }
+    EXPECT_EQ(3u, g_live_messages);
+
+    // Allocated messages are destroyed with the pool if they are not given back
+    EXPECT_NE(nullptr, pool->borrow());
+    EXPECT_NE(nullptr, pool->borrow());
+    EXPECT_NE(nullptr, pool->borrow());
+    void * extra = pool->borrow();
+    ASSERT_NE(nullptr, extra);
+    EXPECT_TRUE(pool->release(extra));
+    EXPECT_FALSE(pool->release(extra));
+    EXPECT_NE(nullptr, pool->borrow());
+    EXPECT_EQ(4u, g_live_messages);
+  }
+  EXPECT_EQ(0u, g_live_messages);
+}
+
+TEST_F(LoanedMessagePoolTest, release_foreign_message) {
+  auto pool = LoanedMessagePool::create(&type_support_, 2u);
+  ASSERT_NE(nullptr, pool);
+
+  FakeMessage foreign;
+  EXPECT_FALSE(pool->release(&foreign));
+
+  auto message = static_cast<uint8_t *>(pool->borrow());
+  ASSERT_NE(nullptr, message);
+  EXPECT_FALSE(pool->release(message + 1));
+  EXPECT_TRUE(pool->release(message));
+}
+
+TEST_F(LoanedMessagePoolTest, release_twice) {
+  auto pool = LoanedMessagePool::create(&type_support_, 4u);
+  ASSERT_NE(nullptr, pool);
+
+  void * first = pool->borrow();
+  void * second = pool->borrow();
+  ASSERT_NE(nullptr, first);
+  ASSERT_NE(nullptr, second);
+
+  // Rejected while other messages are still loaned, and the pool is not full
+  EXPECT_TRUE(pool->release(first));
+  EXPECT_FALSE(pool->release(first));
+
+  // Messages which were never loaned are rejected as well
+  void * third = pool->borrow();
+  ASSERT_EQ(first, third);
+  EXPECT_TRUE(pool->release(second));
+  void * never_loaned = static_cast<uint8_t *>(second) +
+    (static_cast<uint8_t *>(second) - static_cast<uint8_t *>(first));
+  EXPECT_FALSE(pool->release(never_loaned));
+  EXPECT_TRUE(pool->release(third));
+}
+
+TEST_F(LoanedMessagePoolTest, bad_arguments) {
+  EXPECT_EQ(nullptr, LoanedMessagePool::create(&type_support_, 0u));
+
+  type_support_.typesupport_identifier = "not_introspection";
+  EXPECT_EQ(nullptr, LoanedMessagePool::create(&type_support_, 2u));
+}
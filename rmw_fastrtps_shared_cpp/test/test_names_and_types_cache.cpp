@@ -0,0 +1,115 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "rcutils/allocator.h"
+#include "rcutils/strdup.h"
+#include "rcutils/types/string_array.h"
+
+#include "rmw/names_and_types.h"
+
+#include "rmw_fastrtps_shared_cpp/names_and_types_cache.hpp"
+
+using rmw_fastrtps_shared_cpp::NamesAndTypesCache;
+
+namespace
+{
+
+class NamesAndTypesCacheTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    allocator_ = rcutils_get_default_allocator();
+    result_ = rmw_get_zero_initialized_names_and_types();
+    query_ = [this](
+      rcutils_allocator_t * allocator, rmw_names_and_types_t * names_and_types) -> rmw_ret_t
+      {
+        ++queries_;
+        rmw_ret_t ret = rmw_names_and_types_init(names_and_types, 1u, allocator);
+        if (RMW_RET_OK != ret) {
+          return ret;
+        }
+        names_and_types->names.data[0] = rcutils_strdup("/chatter", *allocator);
+        ret = rcutils_string_array_init(&names_and_types->types[0], 1u, allocator);
+        if (RCUTILS_RET_OK != ret) {
+          return RMW_RET_ERROR;
+        }
+        names_and_types->types[0].data[0] = rcutils_strdup("std_msgs/msg/String", *allocator);
+        return RMW_RET_OK;
+      };
+  }
+
+  void TearDown() override
+  {
+    EXPECT_EQ(RMW_RET_OK, rmw_names_and_types_fini(&result_));
+  }
+
+  void get(const std::string & key)
+  {
+    ASSERT_EQ(RMW_RET_OK, rmw_names_and_types_fini(&result_));
+    ASSERT_EQ(RMW_RET_OK, cache_.get(key, query_, &allocator_, &result_));
+    ASSERT_EQ(1u, result_.names.size);
+    EXPECT_STREQ("/chatter", result_.names.data[0]);
+    ASSERT_EQ(1u, result_.types[0].size);
+    EXPECT_STREQ("std_msgs/msg/String", result_.types[0].data[0]);
+  }
+
+  NamesAndTypesCache cache_;
+  NamesAndTypesCache::QueryFunction query_;
+  size_t queries_ = 0u;
+  rcutils_allocator_t allocator_;
+  rmw_names_and_types_t result_;
+};
+
+}  // namespace
+
+TEST_F(NamesAndTypesCacheTest, snapshot_reused_until_invalidated) {
+  get("topics");
+  get("topics");
+  EXPECT_EQ(1u, queries_);
+
+  cache_.invalidate();
+  get("topics");
+  EXPECT_EQ(2u, queries_);
+  get("topics");
+  EXPECT_EQ(2u, queries_);
+}
+
+TEST_F(NamesAndTypesCacheTest, snapshots_per_key) {
+  get("topics");
+  get("services");
+  EXPECT_EQ(2u, queries_);
+  get("topics");
+  get("services");
+  EXPECT_EQ(2u, queries_);
+}
+
+TEST_F(NamesAndTypesCacheTest, query_error) {
+  size_t failed_queries = 0u;
+  auto failing_query = [&](rcutils_allocator_t *, rmw_names_and_types_t *) -> rmw_ret_t
+    {
+      ++failed_queries;
+      return RMW_RET_ERROR;
+    };
+  EXPECT_EQ(RMW_RET_ERROR, cache_.get("topics", failing_query, &allocator_, &result_));
+  EXPECT_EQ(RMW_RET_ERROR, cache_.get("topics", failing_query, &allocator_, &result_));
+  // Errors are not cached
+  EXPECT_EQ(2u, failed_queries);
+  EXPECT_EQ(RMW_RET_OK, rmw_names_and_types_check_zero(&result_));
+}
@@ -0,0 +1,70 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+#include "fastdds/rtps/common/Guid.h"
+#include "fastdds/rtps/common/SerializedPayload.h"
+
+#include "rmw_fastrtps_shared_cpp/response_filter.hpp"
+
+using eprosima::fastdds::dds::IContentFilter;
+using eprosima::fastrtps::rtps::GUID_t;
+using rmw_fastrtps_shared_cpp::ResponseFilter;
+
+namespace
+{
+
+// Entity kinds of section 9.3.1.2 of RTPS
+constexpr uint8_t reader_with_key = 0x07;
+constexpr uint8_t writer_with_key = 0x02;
+
+GUID_t
+make_guid(uint8_t participant, uint8_t entity, uint8_t entity_kind)
+{
+  GUID_t guid;
+  guid.guidPrefix.value[0] = participant;
+  guid.entityId.value[2] = entity;
+  guid.entityId.value[3] = entity_kind;
+  return guid;
+}
+
+bool
+evaluate(const GUID_t & related_guid, const GUID_t & reader_guid)
+{
+  IContentFilter::FilterSampleInfo sample_info;
+  sample_info.related_sample_identity.writer_guid(related_guid);
+  IContentFilter::SerializedPayload payload;
+  return ResponseFilter::get_instance().evaluate(payload, sample_info, reader_guid);
+}
+
+}  // namespace
+
+TEST(ResponseFilterTest, responses_reach_the_requesting_reader) {
+  const GUID_t reader = make_guid(1u, 1u, reader_with_key);
+  const GUID_t other_reader = make_guid(2u, 1u, reader_with_key);
+
+  EXPECT_TRUE(evaluate(reader, reader));
+  EXPECT_FALSE(evaluate(reader, other_reader));
+  EXPECT_FALSE(evaluate(other_reader, reader));
+}
+
+TEST(ResponseFilterTest, responses_related_to_a_writer_are_not_filtered) {
+  const GUID_t reader = make_guid(1u, 1u, reader_with_key);
+  const GUID_t request_writer = make_guid(2u, 1u, writer_with_key);
+
+  EXPECT_TRUE(evaluate(request_writer, reader));
+}
@@ -0,0 +1,106 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+#include "fastdds/rtps/common/CacheChange.h"
+
+#include "rmw_fastrtps_shared_cpp/serialized_payload_pool.hpp"
+
+using eprosima::fastrtps::rtps::CacheChange_t;
+using rmw_fastrtps_shared_cpp::SerializedPayloadPool;
+
+TEST(SerializedPayloadPoolTest, borrowed_buffer_becomes_payload) {
+  SerializedPayloadPool pool(4u);
+  uint32_t capacity = 0u;
+  SerializedPayloadPool::octet * buffer = pool.borrow(64u, capacity);
+  ASSERT_NE(nullptr, buffer);
+  EXPECT_LE(64u, capacity);
+  EXPECT_TRUE(pool.is_borrowed(buffer));
+
+  CacheChange_t change;
+  {
+    SerializedPayloadPool::PublishScope scope(pool, buffer);
+    ASSERT_TRUE(pool.get_payload(32u, change));
+    EXPECT_TRUE(scope.buffer_taken());
+  }
+  EXPECT_EQ(buffer, change.serializedPayload.data);
+  EXPECT_EQ(&pool, change.payload_owner());
+  EXPECT_FALSE(pool.is_borrowed(buffer));
+  // Already taken by the writer
+  EXPECT_FALSE(pool.give_back(buffer));
+
+  EXPECT_TRUE(pool.release_payload(change));
+  EXPECT_EQ(nullptr, change.serializedPayload.data);
+
+  // Released buffers are reused
+  CacheChange_t other_change;
+  ASSERT_TRUE(pool.get_payload(16u, other_change));
+  EXPECT_EQ(buffer, other_change.serializedPayload.data);
+  EXPECT_TRUE(pool.release_payload(other_change));
+}
+
+TEST(SerializedPayloadPoolTest, buffer_not_taken_outside_scope) {
+  SerializedPayloadPool pool(4u);
+  uint32_t capacity = 0u;
+  SerializedPayloadPool::octet * buffer = pool.borrow(64u, capacity);
+  ASSERT_NE(nullptr, buffer);
+
+  CacheChange_t change;
+  ASSERT_TRUE(pool.get_payload(32u, change));
+  EXPECT_NE(buffer, change.serializedPayload.data);
+  EXPECT_TRUE(pool.release_payload(change));
+
+  EXPECT_TRUE(pool.give_back(buffer));
+  EXPECT_FALSE(pool.is_borrowed(buffer));
+  EXPECT_FALSE(pool.give_back(buffer));
+}
+
+TEST(SerializedPayloadPoolTest, borrowed_buffer_too_small) {
+  SerializedPayloadPool pool(4u);
+  uint32_t capacity = 0u;
+  SerializedPayloadPool::octet * buffer = pool.borrow(8u, capacity);
+  ASSERT_NE(nullptr, buffer);
+
+  CacheChange_t change;
+  {
+    SerializedPayloadPool::PublishScope scope(pool, buffer);
+    EXPECT_FALSE(pool.get_payload(capacity + 1u, change));
+    EXPECT_FALSE(scope.buffer_taken());
+  }
+  EXPECT_TRUE(pool.give_back(buffer));
+}
+
+TEST(SerializedPayloadPoolTest, smallest_free_buffer_is_reused) {
+  SerializedPayloadPool pool(4u);
+  CacheChange_t small_change;
+  CacheChange_t big_change;
+  ASSERT_TRUE(pool.get_payload(16u, small_change));
+  ASSERT_TRUE(pool.get_payload(256u, big_change));
+  SerializedPayloadPool::octet * small_buffer = small_change.serializedPayload.data;
+  SerializedPayloadPool::octet * big_buffer = big_change.serializedPayload.data;
+  EXPECT_TRUE(pool.release_payload(big_change));
+  EXPECT_TRUE(pool.release_payload(small_change));
+
+  CacheChange_t change;
+  ASSERT_TRUE(pool.get_payload(8u, change));
+  EXPECT_EQ(small_buffer, change.serializedPayload.data);
+  CacheChange_t other_change;
+  ASSERT_TRUE(pool.get_payload(32u, other_change));
+  EXPECT_EQ(big_buffer, other_change.serializedPayload.data);
+  EXPECT_TRUE(pool.release_payload(change));
+  EXPECT_TRUE(pool.release_payload(other_change));
+}
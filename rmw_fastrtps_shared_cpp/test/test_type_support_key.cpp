@@ -0,0 +1,130 @@
+// Copyright 2023 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "fastdds/rtps/common/InstanceHandle.h"
+
+#include "rmw/serialized_message.h"
+
+#include "rmw_fastrtps_shared_cpp/discovery_info.hpp"
+#include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
+
+using eprosima::fastrtps::rtps::InstanceHandle_t;
+using rmw_fastrtps_shared_cpp::SerializedData;
+using rmw_fastrtps_shared_cpp::discovery_info_key_size;
+
+namespace
+{
+
+// Type support which can only handle serialized messages
+class FakeTypeSupport : public rmw_fastrtps_shared_cpp::TypeSupport
+{
+public:
+  explicit FakeTypeSupport(size_t key_size)
+  {
+    setName("rmw_dds_common::msg::dds_::ParticipantEntitiesInfo_");
+    set_key_size(key_size);
+  }
+
+  size_t getEstimatedSerializedSize(const void *, const void *) const override
+  {
+    return 0u;
+  }
+
+  bool serializeROSmessage(const void *, eprosima::fastcdr::Cdr &, const void *) const override
+  {
+    return false;
+  }
+
+  bool deserializeROSmessage(eprosima::fastcdr::Cdr &, void *, const void *) const override
+  {
+    return false;
+  }
+};
+
+// Serialized ParticipantEntitiesInfo with the given gid and no nodes
+std::vector<uint8_t>
+make_payload(uint8_t gid_seed)
+{
+  std::vector<uint8_t> payload = {0x00, 0x01, 0x00, 0x00};
+  for (size_t i = 0; i < discovery_info_key_size; ++i) {
+    payload.push_back(static_cast<uint8_t>(gid_seed + i));
+  }
+  payload.insert(payload.end(), {0x00, 0x00, 0x00, 0x00});
+  return payload;
+}
+
+bool
+get_key(FakeTypeSupport & type, std::vector<uint8_t> & payload, InstanceHandle_t & handle)
+{
+  rmw_serialized_message_t message = rmw_get_zero_initialized_serialized_message();
+  message.buffer = payload.data();
+  message.buffer_length = payload.size();
+  message.buffer_capacity = payload.size();
+
+  SerializedData data;
+  data.type = rmw_fastrtps_shared_cpp::FASTRTPS_SERIALIZED_DATA_TYPE_SERIALIZED_MESSAGE;
+  data.data = &message;
+  data.impl = nullptr;
+  return type.getKey(&data, &handle);
+}
+
+}  // namespace
+
+TEST(TypeSupportKeyTest, keyed_on_gid) {
+  FakeTypeSupport type(discovery_info_key_size);
+  EXPECT_TRUE(type.m_isGetKeyDefined);
+
+  std::vector<uint8_t> payload = make_payload(1u);
+  InstanceHandle_t handle;
+  ASSERT_TRUE(get_key(type, payload, handle));
+  EXPECT_TRUE(handle.isDefined());
+  if (discovery_info_key_size <= 16u) {
+    EXPECT_EQ(0, memcmp(handle.value, payload.data() + 4, discovery_info_key_size));
+  }
+
+  // Same gid, same instance, whatever the rest of the message
+  std::vector<uint8_t> other_payload = make_payload(1u);
+  other_payload.push_back(0x01);
+  InstanceHandle_t same_handle;
+  ASSERT_TRUE(get_key(type, other_payload, same_handle));
+  EXPECT_EQ(handle, same_handle);
+
+  std::vector<uint8_t> other_gid_payload = make_payload(2u);
+  InstanceHandle_t other_handle;
+  ASSERT_TRUE(get_key(type, other_gid_payload, other_handle));
+  EXPECT_NE(handle, other_handle);
+}
+
+TEST(TypeSupportKeyTest, truncated_payload) {
+  FakeTypeSupport type(discovery_info_key_size);
+  std::vector<uint8_t> payload = make_payload(1u);
+  payload.resize(4u + discovery_info_key_size - 1u);
+  InstanceHandle_t handle;
+  EXPECT_FALSE(get_key(type, payload, handle));
+}
+
+TEST(TypeSupportKeyTest, unkeyed_by_default) {
+  FakeTypeSupport type(0u);
+  EXPECT_FALSE(type.m_isGetKeyDefined);
+
+  std::vector<uint8_t> payload = make_payload(1u);
+  InstanceHandle_t handle;
+  EXPECT_FALSE(get_key(type, payload, handle));
+}